@@ -1,6 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
 
 #include "engine/entity.hpp"
 #include "engine/globals.hpp"
@@ -36,6 +41,11 @@ template <typename T, Component C>
 class ComponentManager
 {
 public:
+	/**
+	 * \brief COMPONENT_FLAG is the flag C of the component, used by View to match the entities.
+	 */
+	static constexpr Component COMPONENT_FLAG = C;
+
 	explicit ComponentManager(EntityManager& entityManager)
 		: _entityManager(entityManager)
 	{
@@ -77,6 +87,13 @@ public:
 	 * \param value is the new value that will be set.
 	 */
 	void SetComponent(Entity entity, const T& value);
+	/**
+	 * \brief SetComponents is a method that sets the components of several entities in one loop,
+	 * without checking each Entity as SetComponent does.
+	 * \param entities will have their component set, they must all own the component
+	 * \param values are the new values, in the order of entities
+	 */
+	void SetComponents(std::span<const Entity> entities, std::span<const T> values);
 	/**
 	 * \brief GetAllComponents is a method that returns the internal array of components
 	 * \return the internal array of components
@@ -88,9 +105,62 @@ public:
 	 * \param components is the new component array to be copy instead of the old components array
 	 */
 	void CopyAllComponents(const std::vector<T>& components);
+	/**
+	 * \brief CopyAllComponents is a method that copies the components of another manager without reallocating.
+	 * Only the components up to the highest Entity that was given a component in one of the managers are copied,
+	 * with memcpy when T is trivially copyable. The array is only grown, so copying worlds of the same size back and forth
+	 * does not allocate.
+	 * \param other is the manager whose components are copied
+	 */
+	void CopyAllComponents(const ComponentManager& other);
+	/**
+	 * \brief ResizeAllComponents is a method that resizes the internal components array and gives access to it to be overwritten.
+	 * It is used by the RollbackManager when restoring the game world from a serialized copy, without going through a temporary array.
+	 * \param size is the new number of components
+	 * \return the internal array of components
+	 */
+	[[nodiscard]] std::span<T> ResizeAllComponents(std::size_t size);
+
+	/**
+	 * \brief SetDirtyTracking is a method that enables the dirty flags, set when a component may be modified
+	 * by AddComponent, the mutable GetComponent and SetComponent. The dirty flags are cleared when it is disabled.
+	 * \param isTracking is true to track the modified components
+	 */
+	void SetDirtyTracking(bool isTracking);
+	[[nodiscard]] bool IsDirtyTracking() const { return _isDirtyTracking; }
+	[[nodiscard]] bool IsDirty(Entity entity) const;
+	/**
+	 * \brief ClearDirty is a method that clears all the dirty flags, when the components were saved.
+	 */
+	void ClearDirty();
+	/**
+	 * \brief ForEachDirty is a method that calls a function with every dirty Entity, in increasing order.
+	 * \param function is called with the Entity
+	 */
+	template <typename Function>
+	void ForEachDirty(Function function) const;
+	/**
+	 * \brief RestoreDirtyComponents is a method that overwrites only the dirty components with saved ones,
+	 * then clears the dirty flags. The other components must not have been modified since the save.
+	 * \param getSavedComponent is called with a dirty Entity and returns its saved component
+	 */
+	template <typename Function>
+	void RestoreDirtyComponents(Function getSavedComponent);
 protected:
 	EntityManager& _entityManager;
 	std::vector<T> _components;
+	/**
+	 * \brief High-water mark of the components, the ones after it were never written and keep their default value.
+	 */
+	std::size_t _componentsEnd = 0;
+
+	/**
+	 * \brief One dirty flag per Entity, in words of 64 entities.
+	 */
+	std::vector<std::uint64_t> _dirtyWords;
+	bool _isDirtyTracking = false;
+
+	void MarkDirty(Entity entity);
 };
 
 template <typename T, Component C>
@@ -111,6 +181,8 @@ void ComponentManager<T, C>::AddComponent(Entity entity)
 		newSize = newSize + newSize / 2;
 	}
 	_components.resize(newSize);
+	_componentsEnd = std::max(_componentsEnd, static_cast<std::size_t>(entity) + 1);
+	MarkDirty(entity);
 
 	_entityManager.AddComponent(entity, C);
 }
@@ -136,6 +208,8 @@ T& ComponentManager<T, C>::GetComponent(Entity entity)
 {
 	gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
 	gpr_warn(_entityManager.HasComponent(entity, C), "Entity has not the requested component");
+	_componentsEnd = std::max(_componentsEnd, static_cast<std::size_t>(entity) + 1);
+	MarkDirty(entity);
 	return _components[entity];
 }
 
@@ -144,9 +218,35 @@ void ComponentManager<T, C>::SetComponent(Entity entity, const T& value)
 {
 	gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
 	gpr_warn(_entityManager.HasComponent(entity, C), "Entity has not the requested component");
+	_componentsEnd = std::max(_componentsEnd, static_cast<std::size_t>(entity) + 1);
+	MarkDirty(entity);
 	_components[entity] = value;
 }
 
+template <typename T, Component C>
+void ComponentManager<T, C>::SetComponents(const std::span<const Entity> entities, const std::span<const T> values)
+{
+	gpr_assert(entities.size() == values.size(), "Every value needs an entity");
+	if (entities.empty()) return;
+
+	const Entity lastEntity = *std::max_element(entities.begin(), entities.end());
+	gpr_assert(lastEntity < _components.size(), "Entity has no component");
+	_componentsEnd = std::max(_componentsEnd, static_cast<std::size_t>(lastEntity) + 1);
+
+	if (_isDirtyTracking)
+	{
+		for (const Entity entity : entities)
+		{
+			MarkDirty(entity);
+		}
+	}
+
+	for (std::size_t i = 0; i < entities.size(); i++)
+	{
+		_components[entities[i]] = values[i];
+	}
+}
+
 template <typename T, Component C>
 const std::vector<T>& ComponentManager<T, C>::GetAllComponents() const
 {
@@ -157,5 +257,107 @@ template <typename T, Component C>
 void ComponentManager<T, C>::CopyAllComponents(const std::vector<T>& components)
 {
 	_components = components;
+	_componentsEnd = _components.size();
+}
+
+template <typename T, Component C>
+void ComponentManager<T, C>::CopyAllComponents(const ComponentManager& other)
+{
+	const std::size_t otherSize = other._components.size();
+	if (_components.size() < otherSize)
+	{
+		_components.resize(otherSize);
+	}
+
+	// After both high-water marks, the components of the two managers are default values
+	const std::size_t copySize = std::min(std::max(_componentsEnd, other._componentsEnd), otherSize);
+	if constexpr (std::is_trivially_copyable_v<T>)
+	{
+		std::memcpy(_components.data(), other._components.data(), copySize * sizeof(T));
+	}
+	else
+	{
+		std::copy_n(other._components.begin(), copySize, _components.begin());
+	}
+
+	// The components the other manager does not have are reset, as if the array was replaced
+	if (_componentsEnd > copySize)
+	{
+		std::fill(_components.begin() + static_cast<std::ptrdiff_t>(copySize),
+		          _components.begin() + static_cast<std::ptrdiff_t>(_componentsEnd), T{});
+	}
+
+	_componentsEnd = copySize;
+}
+
+template <typename T, Component C>
+std::span<T> ComponentManager<T, C>::ResizeAllComponents(const std::size_t size)
+{
+	_components.resize(size);
+	_componentsEnd = size;
+	return _components;
+}
+
+template <typename T, Component C>
+void ComponentManager<T, C>::SetDirtyTracking(const bool isTracking)
+{
+	_isDirtyTracking = isTracking;
+	if (!_isDirtyTracking)
+	{
+		_dirtyWords.clear();
+	}
+}
+
+template <typename T, Component C>
+bool ComponentManager<T, C>::IsDirty(const Entity entity) const
+{
+	const std::size_t word = entity / 64;
+	return word < _dirtyWords.size() && (_dirtyWords[word] >> (entity % 64) & 1u) != 0;
+}
+
+template <typename T, Component C>
+void ComponentManager<T, C>::ClearDirty()
+{
+	std::fill(_dirtyWords.begin(), _dirtyWords.end(), 0);
+}
+
+template <typename T, Component C>
+template <typename Function>
+void ComponentManager<T, C>::ForEachDirty(Function function) const
+{
+	for (std::size_t word = 0; word < _dirtyWords.size(); word++)
+	{
+		std::uint64_t dirtyBits = _dirtyWords[word];
+		while (dirtyBits != 0)
+		{
+			function(static_cast<Entity>(word * 64 + std::countr_zero(dirtyBits)));
+			dirtyBits &= dirtyBits - 1;
+		}
+	}
+}
+
+template <typename T, Component C>
+template <typename Function>
+void ComponentManager<T, C>::RestoreDirtyComponents(Function getSavedComponent)
+{
+	ForEachDirty([this, &getSavedComponent](const Entity entity)
+	{
+		_components[entity] = getSavedComponent(entity);
+	});
+	ClearDirty();
+}
+
+template <typename T, Component C>
+void ComponentManager<T, C>::MarkDirty(const Entity entity)
+{
+	if (!_isDirtyTracking) return;
+
+	const std::size_t word = entity / 64;
+	if (word >= _dirtyWords.size())
+	{
+		_dirtyWords.resize(word + 1, 0);
+	}
+
+	_dirtyWords[word] |= std::uint64_t{1} << (entity % 64);
 }
 } // namespace core
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <limits>
+#include <span>
 #include <vector>
 
 namespace core
@@ -24,6 +25,18 @@ constexpr Entity INVALID_ENTITY = std::numeric_limits<Entity>::max();
  * \brief INVALID_ENTITY_MASK is a constant that define an invalid or empty entity mask.
  */
 constexpr EntityMask INVALID_ENTITY_MASK = 0u;
+/**
+ * \brief EntityHandle is an Entity with the generation of its index when it was referenced.
+ * The generation changes when the Entity is destroyed, so a handle kept after its index was given to a new Entity
+ * is detected with EntityManager::IsEntityHandleValid.
+ */
+struct EntityHandle
+{
+	Entity entity = INVALID_ENTITY;
+	std::uint32_t generation = 0;
+
+	bool operator==(const EntityHandle& other) const = default;
+};
 /**
  * \brief Manages the entities in an array using bitwise operations to know if it has components.
  */
@@ -34,7 +47,7 @@ public:
 	explicit EntityManager(std::size_t reservedSize);
 	/**
 	 * \brief CreateEntity is a method that will return the next available Entity index.
-	 * It will look at the internal entityMasks_ array and give the first one that is free to use.
+	 * It will take the lowest free index from the free list, so the same destroyed entities give the same new ones.
 	 * If none are free, the array is reallocated.
 	 * \return the newly created Entity
 	 */
@@ -42,6 +55,7 @@ public:
 	/**
 	 * \brief DestroyEntity is a method that will erase all Component from the EntityMask.
 	 * It means that EntityExists will be false and that HasComponent will always return false.
+	 * The generation of the Entity is incremented and its index is put back in the free list.
 	 * It will not do anything to the actual ComponentManager.
 	 * \param entity is the mask that will be voided
 	 */
@@ -77,9 +91,47 @@ public:
 	 * \return the total size of the EntityMask array.
 	 */
 	[[nodiscard]] std::size_t GetEntitiesSize() const;
+	/**
+	 * \brief GetEntityMasks is a method that returns the EntityMask array, indexed by Entity.
+	 * It is used by View to match the masks of many entities at once.
+	 */
+	[[nodiscard]] std::span<const EntityMask> GetEntityMasks() const;
+	/**
+	 * \brief SetEntityMasks is a method that replaces the EntityMask array by the one of another EntityManager.
+	 * It is used by the clients to get the same entities as the server when resynchronizing their world.
+	 * The entities without a mask in the new array are destroyed, the others are taken from the free list.
+	 * \param entityMasks is the new EntityMask array, indexed by Entity
+	 * \param keptMask is the Component bitwise mask of the local components, kept from the current masks
+	 */
+	void SetEntityMasks(std::span<const EntityMask> entityMasks, EntityMask keptMask = INVALID_ENTITY_MASK);
+
+	/**
+	 * \brief GetGeneration is a method that returns the number of times an Entity index was destroyed.
+	 */
+	[[nodiscard]] std::uint32_t GetGeneration(Entity entity) const;
+	/**
+	 * \brief GetEntityHandle is a method that returns a handle to an existing Entity, to be validated later.
+	 */
+	[[nodiscard]] EntityHandle GetEntityHandle(Entity entity) const;
+	/**
+	 * \brief IsEntityHandleValid is a method that checks that the Entity of a handle still exists and was not destroyed
+	 * since the handle was taken.
+	 * \param entityHandle is the handle that we check
+	 * \return the statement result if the handle still refers to the same Entity
+	 */
+	[[nodiscard]] bool IsEntityHandleValid(EntityHandle entityHandle) const;
 
 
 private:
 	std::vector<EntityMask> _entityMasks;
+	std::vector<std::uint32_t> _generations;
+
+	/**
+	 * \brief Min-heap of the free indices, entries that were reused by adding a component to them are skipped lazily.
+	 */
+	std::vector<Entity> _freeEntities;
+
+	void Grow();
+	void FreeEntity(Entity entity);
 };
 } // namespace core
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "engine/component.hpp"
+#include "engine/entity.hpp"
+
+#include "utils/assert.hpp"
+
+
+namespace core
+{
+/**
+ * \brief SparseComponentManager is a class that owns Component in a sparse set, an alternative to ComponentManager
+ * for component types owned by few entities.
+ * The components are packed in a dense array, with the Entity owning each of them, and a sparse array gives the dense
+ * index of an Entity. Iterating with ForEach only touches the entities that own the component.
+ * Destroying an Entity does not remove its component, RemoveComponent must be called before, or
+ * RemoveDestroyedComponents after restoring dense arrays saved before the Entity was destroyed.
+ * \tparam T type of the component
+ * \tparam C unique binary flag of the component. This will be set in the EntityMask of the EntityManager when added.
+ */
+template <typename T, Component C>
+class SparseComponentManager
+{
+public:
+	static constexpr Component COMPONENT_FLAG = C;
+
+	explicit SparseComponentManager(EntityManager& entityManager)
+		: _entityManager(entityManager)
+	{
+		_indices.resize(ENTITY_INIT_NMB, INVALID_INDEX);
+	}
+
+	virtual ~SparseComponentManager() = default;
+
+	SparseComponentManager(const SparseComponentManager&) = delete;
+	SparseComponentManager& operator=(SparseComponentManager&) = delete;
+	SparseComponentManager(SparseComponentManager&&) = delete;
+	SparseComponentManager& operator=(SparseComponentManager&&) = delete;
+
+	/**
+	 * \brief AddComponent is a method that sets the flag C in the EntityManager and appends a component to the dense array
+	 * if the Entity does not have one yet.
+	 * \param entity will have its flag C added in EntityManager
+	 */
+	virtual void AddComponent(Entity entity);
+	/**
+	 * \brief RemoveComponent is a method that unsets the flag C in the EntityManager and removes the component of the
+	 * Entity by moving the last component of the dense array in its place.
+	 * \param entity will have its flag C removed
+	 */
+	virtual void RemoveComponent(Entity entity);
+	[[nodiscard]] const T& GetComponent(Entity entity) const;
+	[[nodiscard]] T& GetComponent(Entity entity);
+	void SetComponent(Entity entity, const T& value);
+
+	/**
+	 * \brief ForEach is a method that calls a function with every Entity owning the component and its component.
+	 * \param function is called with the Entity and a reference to its component
+	 */
+	template <typename Function>
+	void ForEach(Function function);
+	template <typename Function>
+	void ForEach(Function function) const;
+
+	/**
+	 * \brief GetAllComponents is a method that returns the dense array of components, in the order of GetAllEntities.
+	 */
+	[[nodiscard]] const std::vector<T>& GetAllComponents() const { return _components; }
+	/**
+	 * \brief GetAllEntities is a method that returns the Entity owning each component of the dense array.
+	 */
+	[[nodiscard]] const std::vector<Entity>& GetAllEntities() const { return _entities; }
+	/**
+	 * \brief CopyAllComponents is a method that replaces the components by the ones of another manager.
+	 * \param other is the manager whose dense arrays are copied
+	 */
+	void CopyAllComponents(const SparseComponentManager& other);
+	/**
+	 * \brief ResizeAllEntities is a method that resizes the dense arrays and gives access to the entities to be overwritten.
+	 * It is used by the RollbackManager when restoring the game world from a serialized copy, the components are then
+	 * written with ResizeAllComponents and the sparse array is updated with RebuildIndices.
+	 * \param size is the new number of components
+	 * \return the dense array of entities
+	 */
+	[[nodiscard]] std::span<Entity> ResizeAllEntities(std::size_t size);
+	[[nodiscard]] std::span<T> ResizeAllComponents(std::size_t size);
+	/**
+	 * \brief RebuildIndices is a method that updates the sparse array after the dense arrays were overwritten.
+	 */
+	void RebuildIndices();
+	/**
+	 * \brief RemoveDestroyedComponents is a method that removes the components of the entities that lost the flag C,
+	 * found in dense arrays restored from a copy saved before their Entity was destroyed.
+	 * The order of the kept components does not change.
+	 */
+	void RemoveDestroyedComponents();
+
+protected:
+	static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+	EntityManager& _entityManager;
+	std::vector<T> _components;
+	std::vector<Entity> _entities;
+	std::vector<std::uint32_t> _indices;
+
+	/**
+	 * \brief ClearIndices is a method that resets the sparse array entries of the dense entities only.
+	 */
+	void ClearIndices();
+};
+
+template <typename T, Component C>
+void SparseComponentManager<T, C>::AddComponent(const Entity entity)
+{
+	gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+	//Invalid entity would allocate too much memory
+	if (entity == INVALID_ENTITY)
+		return;
+	// Resize the sparse array if too small
+	if (entity >= _indices.size())
+	{
+		auto newSize = _indices.size();
+		while (entity >= newSize)
+		{
+			newSize = newSize + newSize / 2;
+		}
+		_indices.resize(newSize, INVALID_INDEX);
+	}
+
+	if (_indices[entity] == INVALID_INDEX)
+	{
+		_indices[entity] = static_cast<std::uint32_t>(_components.size());
+		_components.emplace_back();
+		_entities.push_back(entity);
+	}
+
+	_entityManager.AddComponent(entity, C);
+}
+
+template <typename T, Component C>
+void SparseComponentManager<T, C>::RemoveComponent(const Entity entity)
+{
+	gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+	gpr_warn(_entityManager.HasComponent(entity, C), "Entity has not the removing component");
+	_entityManager.RemoveComponent(entity, C);
+	if (entity >= _indices.size() || _indices[entity] == INVALID_INDEX) return;
+
+	// The last component fills the hole, the dense array stays packed
+	const std::uint32_t index = _indices[entity];
+	const Entity lastEntity = _entities.back();
+	_components[index] = std::move(_components.back());
+	_entities[index] = lastEntity;
+	_indices[lastEntity] = index;
+	_indices[entity] = INVALID_INDEX;
+	_components.pop_back();
+	_entities.pop_back();
+}
+
+template <typename T, Component C>
+const T& SparseComponentManager<T, C>::GetComponent(const Entity entity) const
+{
+	gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+	gpr_warn(_entityManager.HasComponent(entity, C), "Entity has not the requested component");
+	gpr_assert(entity < _indices.size() && _indices[entity] != INVALID_INDEX, "Entity has no component in the set");
+	return _components[_indices[entity]];
+}
+
+template <typename T, Component C>
+T& SparseComponentManager<T, C>::GetComponent(const Entity entity)
+{
+	gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+	gpr_warn(_entityManager.HasComponent(entity, C), "Entity has not the requested component");
+	gpr_assert(entity < _indices.size() && _indices[entity] != INVALID_INDEX, "Entity has no component in the set");
+	return _components[_indices[entity]];
+}
+
+template <typename T, Component C>
+void SparseComponentManager<T, C>::SetComponent(const Entity entity, const T& value)
+{
+	GetComponent(entity) = value;
+}
+
+template <typename T, Component C>
+template <typename Function>
+void SparseComponentManager<T, C>::ForEach(Function function)
+{
+	for (std::size_t index = 0; index < _entities.size(); index++)
+	{
+		if (!_entityManager.HasComponent(_entities[index], C)) continue;
+
+		function(_entities[index], _components[index]);
+	}
+}
+
+template <typename T, Component C>
+template <typename Function>
+void SparseComponentManager<T, C>::ForEach(Function function) const
+{
+	for (std::size_t index = 0; index < _entities.size(); index++)
+	{
+		if (!_entityManager.HasComponent(_entities[index], C)) continue;
+
+		function(_entities[index], _components[index]);
+	}
+}
+
+template <typename T, Component C>
+void SparseComponentManager<T, C>::CopyAllComponents(const SparseComponentManager& other)
+{
+	ClearIndices();
+	_components = other._components;
+	_entities = other._entities;
+	RebuildIndices();
+}
+
+template <typename T, Component C>
+std::span<Entity> SparseComponentManager<T, C>::ResizeAllEntities(const std::size_t size)
+{
+	ClearIndices();
+	_entities.resize(size);
+	_components.resize(size);
+	return _entities;
+}
+
+template <typename T, Component C>
+std::span<T> SparseComponentManager<T, C>::ResizeAllComponents(const std::size_t size)
+{
+	gpr_assert(size == _entities.size(), "Every component needs an entity");
+	_components.resize(size);
+	return _components;
+}
+
+template <typename T, Component C>
+void SparseComponentManager<T, C>::RebuildIndices()
+{
+	for (std::size_t index = 0; index < _entities.size(); index++)
+	{
+		const Entity entity = _entities[index];
+		if (entity >= _indices.size())
+		{
+			_indices.resize(entity + entity / 2 + 1, INVALID_INDEX);
+		}
+
+		_indices[entity] = static_cast<std::uint32_t>(index);
+	}
+}
+
+template <typename T, Component C>
+void SparseComponentManager<T, C>::RemoveDestroyedComponents()
+{
+	std::size_t keptCount = 0;
+	for (std::size_t index = 0; index < _entities.size(); index++)
+	{
+		const Entity entity = _entities[index];
+		if (!_entityManager.HasComponent(entity, C))
+		{
+			_indices[entity] = INVALID_INDEX;
+			continue;
+		}
+
+		_indices[entity] = static_cast<std::uint32_t>(keptCount);
+		_entities[keptCount] = entity;
+		_components[keptCount] = std::move(_components[index]);
+		keptCount++;
+	}
+
+	_entities.resize(keptCount);
+	_components.resize(keptCount);
+}
+
+template <typename T, Component C>
+void SparseComponentManager<T, C>::ClearIndices()
+{
+	for (const Entity entity : _entities)
+	{
+		_indices[entity] = INVALID_INDEX;
+	}
+}
+} // namespace core
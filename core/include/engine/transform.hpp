@@ -1,4 +1,6 @@
 #pragma once
+#include <span>
+
 #include <engine/entity.hpp>
 
 #include "component.hpp"
@@ -49,6 +51,12 @@ public:
 	[[nodiscard]] Vec2f GetPosition(Entity entity) const;
 	[[nodiscard]] const std::vector<Vec2f>& GetAllPositions() const;
 	void SetPosition(Entity entity, Vec2f position);
+	/**
+	 * \brief SetPositions is a method that sets the positions of several entities at once.
+	 * \param entities will have their position set
+	 * \param positions are the new positions, in the order of entities
+	 */
+	void SetPositions(std::span<const Entity> entities, std::span<const Vec2f> positions);
 
 	[[nodiscard]] Vec2f GetScale(Entity entity) const;
 	[[nodiscard]] const std::vector<Vec2f>& GetAllScales() const;
@@ -57,6 +65,7 @@ public:
 	[[nodiscard]] Degree GetRotation(Entity entity) const;
 	[[nodiscard]] const std::vector<Degree>& GetAllRotations() const;
 	void SetRotation(Entity entity, Degree rotation);
+	void SetRotations(std::span<const Entity> entities, std::span<const Degree> rotations);
 
 	void AddComponent(Entity entity);
 	void RemoveComponent(Entity entity);
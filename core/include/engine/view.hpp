@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#include "engine/entity.hpp"
+
+namespace core
+{
+/**
+ * \brief View is a class that iterates over the entities owning the components of several component managers.
+ * The entity masks are matched by blocks of 64 entities, each block giving a word with one bit per matching Entity,
+ * and the runs of entities that do not match are skipped by counting the trailing zeros of the word.
+ * The entities are visited in increasing order.
+ * \tparam Managers types of the component managers, a const manager only gives constant references to its components
+ */
+template <typename... Managers>
+class View
+{
+public:
+	explicit View(const EntityManager& entityManager, Managers&... managers)
+		: _entityManager(entityManager),
+		  _managers(managers...),
+		  _requiredMask((static_cast<EntityMask>(std::remove_const_t<Managers>::COMPONENT_FLAG) | ... | 0u))
+	{
+	}
+
+	/**
+	 * \brief With is a method that adds flags the entities must have, without accessing their components.
+	 * \param mask is the Component bitwise mask the entities must have
+	 */
+	View& With(const EntityMask mask)
+	{
+		_requiredMask |= mask;
+		return *this;
+	}
+
+	/**
+	 * \brief Without is a method that skips the entities having any of the flags of a mask.
+	 * \param mask is the Component bitwise mask the entities must not have
+	 */
+	View& Without(const EntityMask mask)
+	{
+		_excludedMask |= mask;
+		return *this;
+	}
+
+	/**
+	 * \brief ForEach is a method that calls a function with every matching Entity and a reference to each of its components.
+	 * A block is matched before its entities are visited, so the function should not remove the components of the other
+	 * entities of the view.
+	 * \param function is called with the Entity, then the components in the order of the managers
+	 */
+	template <typename Function>
+	void ForEach(Function function) const;
+
+private:
+	static constexpr std::size_t BLOCK_SIZE = 64;
+
+	const EntityManager& _entityManager;
+	std::tuple<Managers&...> _managers;
+	EntityMask _requiredMask = INVALID_ENTITY_MASK;
+	EntityMask _excludedMask = INVALID_ENTITY_MASK;
+
+	[[nodiscard]] std::uint64_t MatchBlock(std::size_t blockStart) const;
+};
+
+template <typename... Managers>
+template <typename Function>
+void View<Managers...>::ForEach(Function function) const
+{
+	// The size is read again for every block, the function may create entities
+	for (std::size_t blockStart = 0; blockStart < _entityManager.GetEntitiesSize(); blockStart += BLOCK_SIZE)
+	{
+		std::uint64_t matches = MatchBlock(blockStart);
+		while (matches != 0)
+		{
+			const auto entity = static_cast<Entity>(blockStart + std::countr_zero(matches));
+			matches &= matches - 1;
+
+			std::apply([&function, entity](auto&... managers)
+			{
+				function(entity, managers.GetComponent(entity)...);
+			}, _managers);
+		}
+	}
+}
+
+template <typename... Managers>
+std::uint64_t View<Managers...>::MatchBlock(const std::size_t blockStart) const
+{
+	const auto entityMasks = _entityManager.GetEntityMasks();
+	const std::size_t blockSize = std::min(BLOCK_SIZE, entityMasks.size() - blockStart);
+
+	// Branchless comparisons over the whole block, so the compiler can vectorize them
+	std::uint64_t matches = 0;
+	for (std::size_t i = 0; i < blockSize; i++)
+	{
+		const EntityMask mask = entityMasks[blockStart + i];
+		const bool isMatch = mask != INVALID_ENTITY_MASK &&
+			(mask & _requiredMask) == _requiredMask &&
+			(mask & _excludedMask) == INVALID_ENTITY_MASK;
+		matches |= static_cast<std::uint64_t>(isMatch) << i;
+	}
+
+	return matches;
+}
+} // namespace core
@@ -1,6 +1,7 @@
 #include "engine/entity.hpp"
 
 #include <algorithm>
+#include <functional>
 
 #include "engine/component.hpp"
 
@@ -9,44 +10,51 @@
 namespace core
 {
 EntityManager::EntityManager()
+	: EntityManager(ENTITY_INIT_NMB)
 {
-	_entityMasks.resize(ENTITY_INIT_NMB, INVALID_ENTITY_MASK);
 }
 
 EntityManager::EntityManager(const std::size_t reservedSize)
 {
 	_entityMasks.resize(reservedSize, INVALID_ENTITY_MASK);
+	_generations.resize(reservedSize, 0);
+
+	// Sorted indices are already a min-heap
+	_freeEntities.resize(reservedSize);
+	for (std::size_t i = 0; i < reservedSize; i++)
+	{
+		_freeEntities[i] = static_cast<Entity>(i);
+	}
 }
 
 Entity EntityManager::CreateEntity()
 {
-	const auto entityMaskIt = std::ranges::find_if(_entityMasks,
-	                                               [](const EntityMask entityMask)
-	                                               {
-		                                               return entityMask == INVALID_ENTITY_MASK;
-	                                               });
-
-	if (entityMaskIt == _entityMasks.end())
+	while (true)
 	{
-		const auto newEntity = _entityMasks.size();
-		_entityMasks.resize(newEntity + newEntity / 2, INVALID_ENTITY_MASK);
-		AddComponent(
-			static_cast<Entity>(newEntity),
-			static_cast<EntityMask>(ComponentType::Empty));
-		return static_cast<Entity>(newEntity);
-	}
+		if (_freeEntities.empty())
+		{
+			Grow();
+		}
+
+		std::ranges::pop_heap(_freeEntities, std::greater<>());
+		const Entity newEntity = _freeEntities.back();
+		_freeEntities.pop_back();
 
-	const auto newEntity = std::distance(_entityMasks.begin(), entityMaskIt);
-	AddComponent(
-		static_cast<Entity>(newEntity),
-		static_cast<EntityMask>(ComponentType::Empty));
-	return static_cast<Entity>(newEntity);
+		// The index was used again by adding a component to it
+		if (_entityMasks[newEntity] != INVALID_ENTITY_MASK) continue;
+
+		AddComponent(newEntity, static_cast<EntityMask>(ComponentType::Empty));
+		return newEntity;
+	}
 }
 
 void EntityManager::DestroyEntity(const Entity entity)
 {
 	gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+	if (_entityMasks[entity] == INVALID_ENTITY_MASK) return;
+
 	_entityMasks[entity] = INVALID_ENTITY_MASK;
+	FreeEntity(entity);
 }
 
 void EntityManager::AddComponent(const Entity entity, const EntityMask mask)
@@ -58,7 +66,15 @@ void EntityManager::AddComponent(const Entity entity, const EntityMask mask)
 void EntityManager::RemoveComponent(const Entity entity, const EntityMask mask)
 {
 	gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+	if (_entityMasks[entity] == INVALID_ENTITY_MASK) return;
+
 	_entityMasks[entity] &= ~mask;
+
+	// An entity without any component left does not exist anymore
+	if (_entityMasks[entity] == INVALID_ENTITY_MASK)
+	{
+		FreeEntity(entity);
+	}
 }
 
 bool EntityManager::EntityExists(const Entity entity) const
@@ -72,9 +88,75 @@ std::size_t EntityManager::GetEntitiesSize() const
 	return _entityMasks.size();
 }
 
+std::span<const EntityMask> EntityManager::GetEntityMasks() const
+{
+	return _entityMasks;
+}
+
 bool EntityManager::HasComponent(const Entity entity, const EntityMask mask) const
 {
 	gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
 	return (_entityMasks[entity] & mask) == mask;
 }
+
+void EntityManager::SetEntityMasks(const std::span<const EntityMask> entityMasks, const EntityMask keptMask)
+{
+	while (_entityMasks.size() < entityMasks.size())
+	{
+		Grow();
+	}
+
+	for (std::size_t i = 0; i < _entityMasks.size(); i++)
+	{
+		const auto entity = static_cast<Entity>(i);
+		const EntityMask newMask = i < entityMasks.size() ? entityMasks[i] & ~keptMask : INVALID_ENTITY_MASK;
+		if (newMask == INVALID_ENTITY_MASK)
+		{
+			DestroyEntity(entity);
+			continue;
+		}
+
+		// An index that was free stays in the free list, it is skipped lazily as when adding a component to it
+		_entityMasks[entity] = newMask | (_entityMasks[entity] & keptMask);
+	}
+}
+
+std::uint32_t EntityManager::GetGeneration(const Entity entity) const
+{
+	gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+	return _generations[entity];
+}
+
+EntityHandle EntityManager::GetEntityHandle(const Entity entity) const
+{
+	gpr_assert(EntityExists(entity), "Only existing entities have a handle");
+	return {entity, _generations[entity]};
+}
+
+bool EntityManager::IsEntityHandleValid(const EntityHandle entityHandle) const
+{
+	if (entityHandle.entity == INVALID_ENTITY || entityHandle.entity >= _entityMasks.size()) return false;
+
+	return EntityExists(entityHandle.entity) && _generations[entityHandle.entity] == entityHandle.generation;
+}
+
+void EntityManager::Grow()
+{
+	const std::size_t oldSize = _entityMasks.size();
+	const std::size_t newSize = oldSize + oldSize / 2 + 1;
+	_entityMasks.resize(newSize, INVALID_ENTITY_MASK);
+	_generations.resize(newSize, 0);
+	for (std::size_t i = oldSize; i < newSize; i++)
+	{
+		_freeEntities.push_back(static_cast<Entity>(i));
+		std::ranges::push_heap(_freeEntities, std::greater<>());
+	}
+}
+
+void EntityManager::FreeEntity(const Entity entity)
+{
+	_generations[entity]++;
+	_freeEntities.push_back(entity);
+	std::ranges::push_heap(_freeEntities, std::greater<>());
+}
 }
@@ -40,6 +40,11 @@ void TransformManager::SetPosition(const Entity entity, const Vec2f position)
 	_positionManager.SetComponent(entity, position);
 }
 
+void TransformManager::SetPositions(const std::span<const Entity> entities, const std::span<const Vec2f> positions)
+{
+	_positionManager.SetComponents(entities, positions);
+}
+
 Vec2f TransformManager::GetScale(const Entity entity) const
 {
 	return _scaleManager.GetComponent(entity);
@@ -60,6 +65,11 @@ void TransformManager::SetRotation(const Entity entity, const Degree rotation)
 	_rotationManager.SetComponent(entity, rotation);
 }
 
+void TransformManager::SetRotations(const std::span<const Entity> entities, const std::span<const Degree> rotations)
+{
+	_rotationManager.SetComponents(entities, rotations);
+}
+
 void TransformManager::AddComponent(const Entity entity)
 {
 	_positionManager.AddComponent(entity);
@@ -1,6 +1,7 @@
 #include "graphics/sprite.hpp"
 
 #include "engine/transform.hpp"
+#include "engine/view.hpp"
 
 namespace core
 {
@@ -16,11 +17,8 @@ void SpriteManager::SetTexture(const Entity entity, const sf::Texture& texture)
 
 void SpriteManager::Draw(sf::RenderTarget& window)
 {
-	for (Entity entity = 0; entity < _components.size(); entity++)
+	View(_entityManager, *this).ForEach([this, &window](const Entity entity, sf::Sprite& sprite)
 	{
-		const bool hasSprite = _entityManager.HasComponent(entity, static_cast<Component>(ComponentType::Sprite));
-		if (!hasSprite) continue;
-
 		const bool hasPosition = _entityManager.HasComponent(entity, static_cast<Component>(ComponentType::Position));
 		const bool hasScale = _entityManager.HasComponent(entity, static_cast<Component>(ComponentType::Scale));
 		const bool hasRotation = _entityManager.HasComponent(entity, static_cast<Component>(ComponentType::Rotation));
@@ -28,7 +26,7 @@ void SpriteManager::Draw(sf::RenderTarget& window)
 		if (hasPosition)
 		{
 			const auto position = _transformManager.GetPosition(entity);
-			_components[entity].setPosition(
+			sprite.setPosition(
 				position.x * PIXEL_PER_METER + _center.x,
 				_windowSize.y - (position.y * PIXEL_PER_METER + _center.y));
 		}
@@ -36,17 +34,17 @@ void SpriteManager::Draw(sf::RenderTarget& window)
 		if (hasScale)
 		{
 			const auto scale = _transformManager.GetScale(entity);
-			_components[entity].setScale(scale);
+			sprite.setScale(scale);
 		}
 
 		if (hasRotation)
 		{
 			const auto rotation = _transformManager.GetRotation(entity);
-			_components[entity].setRotation(rotation.Value());
+			sprite.setRotation(rotation.Value());
 		}
 
-		window.draw(_components[entity]);
-	}
+		window.draw(sprite);
+	});
 }
 
 void SpriteManager::SetColor(const Entity entity, const sf::Color color)
@@ -1,4 +1,6 @@
 #include <cmath>
+#include <string>
+#include <vector>
 
 #include <engine/entity.hpp>
 
@@ -41,6 +43,31 @@ TEST(Component, GetComponent)
 	EXPECT_EQ(immutableValue, mutableValue);
 }
 
+TEST(Component, SetComponents)
+{
+	core::EntityManager entityManager;
+	SimpleComponentManager componentManager(entityManager);
+
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	const auto entity3 = entityManager.CreateEntity();
+	componentManager.AddComponent(entity1);
+	componentManager.AddComponent(entity2);
+	componentManager.AddComponent(entity3);
+	componentManager.SetDirtyTracking(true);
+	componentManager.ClearDirty();
+
+	const std::vector entities{entity3, entity1};
+	const std::vector values{3, 1};
+	componentManager.SetComponents(entities, values);
+	EXPECT_TRUE(componentManager.IsDirty(entity1));
+	EXPECT_FALSE(componentManager.IsDirty(entity2));
+	EXPECT_TRUE(componentManager.IsDirty(entity3));
+	EXPECT_EQ(componentManager.GetAllComponents()[entity1], 1);
+	EXPECT_EQ(componentManager.GetAllComponents()[entity2], 0);
+	EXPECT_EQ(componentManager.GetAllComponents()[entity3], 3);
+}
+
 TEST(Component, CopyAllComponents)
 {
 	constexpr int oldValue1 = 45;
@@ -64,6 +91,130 @@ TEST(Component, CopyAllComponents)
 	EXPECT_EQ(oldComponentManager.GetComponent(entity2), newValue2);
 }
 
+TEST(Component, CopyAllComponentsFromManager)
+{
+	constexpr int oldValue1 = 45;
+	constexpr int oldValue3 = 46;
+	constexpr int newValue1 = 43;
+	core::EntityManager entityManager;
+	SimpleComponentManager oldComponentManager(entityManager);
+	SimpleComponentManager newComponentManager(entityManager);
+
+	const auto entity1 = entityManager.CreateEntity();
+	entityManager.CreateEntity();
+	const auto entity3 = entityManager.CreateEntity();
+	oldComponentManager.AddComponent(entity1);
+	oldComponentManager.SetComponent(entity1, oldValue1);
+	oldComponentManager.AddComponent(entity3);
+	oldComponentManager.SetComponent(entity3, oldValue3);
+	newComponentManager.AddComponent(entity1);
+	newComponentManager.SetComponent(entity1, newValue1);
+
+	// The component the new manager never had is reset
+	oldComponentManager.CopyAllComponents(newComponentManager);
+	EXPECT_EQ(oldComponentManager.GetComponent(entity1), newValue1);
+	EXPECT_EQ(oldComponentManager.GetAllComponents()[entity3], 0);
+}
+
+TEST(Component, CopyAllComponentsNotTriviallyCopyable)
+{
+	class StringComponentManager : public core::ComponentManager<std::string, COMPONENT_TYPE>
+	{
+		using ComponentManager::ComponentManager;
+	};
+
+	core::EntityManager entityManager;
+	StringComponentManager oldComponentManager(entityManager);
+	StringComponentManager newComponentManager(entityManager);
+
+	// Grows the new manager over the initial size
+	for (std::size_t i = 0; i < core::ENTITY_INIT_NMB; i++)
+	{
+		entityManager.CreateEntity();
+	}
+	const auto entity = entityManager.CreateEntity();
+	newComponentManager.AddComponent(entity);
+	newComponentManager.SetComponent(entity, "A string that does not fit in the small string buffer");
+
+	oldComponentManager.CopyAllComponents(newComponentManager);
+	EXPECT_EQ(oldComponentManager.GetAllComponents().size(), newComponentManager.GetAllComponents().size());
+	EXPECT_EQ(oldComponentManager.GetAllComponents()[entity], newComponentManager.GetComponent(entity));
+}
+
+TEST(Component, ResizeAllComponents)
+{
+	constexpr int newValue = 42;
+	core::EntityManager entityManager;
+	SimpleComponentManager componentManager(entityManager);
+
+	const auto entity = entityManager.CreateEntity();
+	componentManager.AddComponent(entity);
+
+	const auto components = componentManager.ResizeAllComponents(core::ENTITY_INIT_NMB * 2);
+	EXPECT_EQ(components.size(), core::ENTITY_INIT_NMB * 2);
+	components[entity] = newValue;
+	EXPECT_EQ(componentManager.GetComponent(entity), newValue);
+	EXPECT_EQ(componentManager.GetAllComponents().size(), core::ENTITY_INIT_NMB * 2);
+}
+
+TEST(Component, DirtyTracking)
+{
+	core::EntityManager entityManager;
+	SimpleComponentManager componentManager(entityManager);
+
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	componentManager.AddComponent(entity1);
+	EXPECT_FALSE(componentManager.IsDirty(entity1));
+
+	componentManager.SetDirtyTracking(true);
+	componentManager.AddComponent(entity2);
+	EXPECT_FALSE(componentManager.IsDirty(entity1));
+	EXPECT_TRUE(componentManager.IsDirty(entity2));
+
+	componentManager.ClearDirty();
+	const SimpleComponentManager& constComponentManager = componentManager;
+	[[maybe_unused]] const int value = constComponentManager.GetComponent(entity1);
+	EXPECT_FALSE(componentManager.IsDirty(entity1));
+	componentManager.GetComponent(entity1) = 1;
+	EXPECT_TRUE(componentManager.IsDirty(entity1));
+	EXPECT_FALSE(componentManager.IsDirty(entity2));
+}
+
+TEST(Component, RestoreDirtyComponents)
+{
+	constexpr int savedValue = 45;
+	constexpr int newValue = 43;
+	core::EntityManager entityManager;
+	SimpleComponentManager componentManager(entityManager);
+	componentManager.SetDirtyTracking(true);
+
+	// Spans several words of dirty flags
+	std::vector<core::Entity> entities;
+	for (std::size_t i = 0; i < 150; i++)
+	{
+		const auto entity = entityManager.CreateEntity();
+		componentManager.AddComponent(entity);
+		componentManager.SetComponent(entity, savedValue);
+		entities.push_back(entity);
+	}
+	const std::vector<int> savedComponents = componentManager.GetAllComponents();
+	componentManager.ClearDirty();
+
+	componentManager.SetComponent(entities[3], newValue);
+	componentManager.SetComponent(entities[130], newValue);
+
+	std::vector<core::Entity> restoredEntities;
+	componentManager.RestoreDirtyComponents([&savedComponents, &restoredEntities](const core::Entity entity)
+	{
+		restoredEntities.push_back(entity);
+		return savedComponents[entity];
+	});
+	EXPECT_EQ(restoredEntities, (std::vector{entities[3], entities[130]}));
+	EXPECT_EQ(componentManager.GetAllComponents(), savedComponents);
+	EXPECT_FALSE(componentManager.IsDirty(entities[3]));
+}
+
 TEST(Component, InternalArrayOverflow)
 {
 	core::EntityManager entityManager;
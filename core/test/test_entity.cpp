@@ -1,4 +1,5 @@
 #include <cmath>
+#include <vector>
 
 #include <engine/entity.hpp>
 
@@ -45,3 +46,73 @@ TEST(Entity, EntityComponent)
 	EXPECT_FALSE(entityManager.HasComponent(newEntity, newComponent));
 	EXPECT_FALSE(entityManager.HasComponent(newEntity, newComponent2));
 }
+
+TEST(Entity, ReuseLowestDestroyedEntity)
+{
+	core::EntityManager entityManager;
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	const auto entity3 = entityManager.CreateEntity();
+
+	entityManager.DestroyEntity(entity3);
+	entityManager.DestroyEntity(entity1);
+	EXPECT_EQ(entityManager.CreateEntity(), entity1);
+	EXPECT_EQ(entityManager.CreateEntity(), entity3);
+	EXPECT_TRUE(entityManager.EntityExists(entity2));
+}
+
+TEST(Entity, InternalArrayOverflow)
+{
+	core::EntityManager entityManager(1);
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	EXPECT_NE(entity1, entity2);
+	EXPECT_LT(1, entityManager.GetEntitiesSize());
+	EXPECT_TRUE(entityManager.EntityExists(entity2));
+}
+
+TEST(Entity, EntityHandle)
+{
+	core::EntityManager entityManager;
+	const auto entity = entityManager.CreateEntity();
+	const auto entityHandle = entityManager.GetEntityHandle(entity);
+	EXPECT_TRUE(entityManager.IsEntityHandleValid(entityHandle));
+
+	entityManager.DestroyEntity(entity);
+	EXPECT_FALSE(entityManager.IsEntityHandleValid(entityHandle));
+
+	// The index is reused, but the old handle still refers to the destroyed entity
+	const auto newEntity = entityManager.CreateEntity();
+	EXPECT_EQ(newEntity, entity);
+	EXPECT_FALSE(entityManager.IsEntityHandleValid(entityHandle));
+	EXPECT_TRUE(entityManager.IsEntityHandleValid(entityManager.GetEntityHandle(newEntity)));
+	EXPECT_FALSE(entityManager.IsEntityHandleValid({}));
+}
+
+TEST(Entity, SetEntityMasks)
+{
+	static constexpr core::Component sharedComponent = 2u;
+	static constexpr core::Component localComponent = 4u;
+	core::EntityManager entityManager(2);
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	entityManager.AddComponent(entity1, sharedComponent | localComponent);
+	entityManager.AddComponent(entity2, localComponent);
+	const auto entity2Handle = entityManager.GetEntityHandle(entity2);
+
+	// The first entity is kept with its local component, the second is destroyed and a third one is added
+	const std::vector<core::EntityMask> entityMasks{
+		sharedComponent, core::INVALID_ENTITY_MASK, sharedComponent | localComponent
+	};
+	entityManager.SetEntityMasks(entityMasks, localComponent);
+	EXPECT_LE(entityMasks.size(), entityManager.GetEntitiesSize());
+	EXPECT_TRUE(entityManager.HasComponent(entity1, sharedComponent | localComponent));
+	EXPECT_FALSE(entityManager.EntityExists(entity2));
+	EXPECT_FALSE(entityManager.IsEntityHandleValid(entity2Handle));
+	EXPECT_TRUE(entityManager.HasComponent(2, sharedComponent));
+	EXPECT_FALSE(entityManager.HasComponent(2, localComponent));
+
+	// The destroyed entity is reused, the added one is not given again
+	EXPECT_EQ(entityManager.CreateEntity(), entity2);
+	EXPECT_NE(entityManager.CreateEntity(), 2u);
+}
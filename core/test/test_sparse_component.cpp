@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <vector>
+
+#include <engine/entity.hpp>
+
+#include <gtest/gtest.h>
+
+#include "engine/sparse_component.hpp"
+
+constexpr core::EntityMask SPARSE_COMPONENT_TYPE = 4u;
+
+class SimpleSparseComponentManager : public core::SparseComponentManager<int, SPARSE_COMPONENT_TYPE>
+{
+	using SparseComponentManager::SparseComponentManager;
+};
+
+TEST(SparseComponent, AddComponent)
+{
+	core::EntityManager entityManager;
+	SimpleSparseComponentManager componentManager(entityManager);
+
+	const auto entity = entityManager.CreateEntity();
+	EXPECT_FALSE(entityManager.HasComponent(entity, SPARSE_COMPONENT_TYPE));
+	componentManager.AddComponent(entity);
+	EXPECT_TRUE(entityManager.HasComponent(entity, SPARSE_COMPONENT_TYPE));
+	EXPECT_EQ(componentManager.GetAllComponents().size(), 1);
+	componentManager.RemoveComponent(entity);
+	EXPECT_FALSE(entityManager.HasComponent(entity, SPARSE_COMPONENT_TYPE));
+	EXPECT_TRUE(componentManager.GetAllComponents().empty());
+}
+
+TEST(SparseComponent, RemoveKeepsDenseArrayPacked)
+{
+	core::EntityManager entityManager;
+	SimpleSparseComponentManager componentManager(entityManager);
+
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	const auto entity3 = entityManager.CreateEntity();
+	componentManager.AddComponent(entity1);
+	componentManager.SetComponent(entity1, 1);
+	componentManager.AddComponent(entity2);
+	componentManager.SetComponent(entity2, 2);
+	componentManager.AddComponent(entity3);
+	componentManager.SetComponent(entity3, 3);
+
+	componentManager.RemoveComponent(entity1);
+	EXPECT_EQ(componentManager.GetAllComponents().size(), 2);
+	EXPECT_EQ(componentManager.GetComponent(entity2), 2);
+	EXPECT_EQ(componentManager.GetComponent(entity3), 3);
+}
+
+TEST(SparseComponent, ForEachSkipsEntitiesWithoutComponent)
+{
+	core::EntityManager entityManager;
+	SimpleSparseComponentManager componentManager(entityManager);
+
+	for (std::size_t i = 0; i < core::ENTITY_INIT_NMB; i++)
+	{
+		entityManager.CreateEntity();
+	}
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	componentManager.AddComponent(entity1);
+	componentManager.AddComponent(entity2);
+	entityManager.DestroyEntity(entity2);
+
+	std::vector<core::Entity> visitedEntities;
+	componentManager.ForEach([&visitedEntities](const core::Entity entity, int& component)
+	{
+		component = 42;
+		visitedEntities.push_back(entity);
+	});
+	ASSERT_EQ(visitedEntities.size(), 1);
+	EXPECT_EQ(visitedEntities[0], entity1);
+	EXPECT_EQ(componentManager.GetComponent(entity1), 42);
+}
+
+TEST(SparseComponent, CopyAllComponents)
+{
+	constexpr int oldValue1 = 45;
+	constexpr int newValue1 = 43;
+	constexpr int newValue2 = 47;
+	core::EntityManager entityManager;
+	SimpleSparseComponentManager oldComponentManager(entityManager);
+	SimpleSparseComponentManager newComponentManager(entityManager);
+
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	oldComponentManager.AddComponent(entity1);
+	oldComponentManager.SetComponent(entity1, oldValue1);
+	newComponentManager.AddComponent(entity2);
+	newComponentManager.SetComponent(entity2, newValue2);
+	newComponentManager.AddComponent(entity1);
+	newComponentManager.SetComponent(entity1, newValue1);
+
+	oldComponentManager.CopyAllComponents(newComponentManager);
+	EXPECT_EQ(oldComponentManager.GetComponent(entity1), newValue1);
+	EXPECT_EQ(oldComponentManager.GetComponent(entity2), newValue2);
+}
+
+TEST(SparseComponent, ResizeAllEntities)
+{
+	constexpr int newValue = 42;
+	core::EntityManager entityManager;
+	SimpleSparseComponentManager componentManager(entityManager);
+
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	componentManager.AddComponent(entity1);
+
+	// The dense arrays are overwritten as when loading a serialized world
+	const auto entities = componentManager.ResizeAllEntities(1);
+	entities[0] = entity2;
+	const auto components = componentManager.ResizeAllComponents(1);
+	components[0] = newValue;
+	componentManager.RebuildIndices();
+	entityManager.AddComponent(entity2, SPARSE_COMPONENT_TYPE);
+
+	EXPECT_EQ(componentManager.GetComponent(entity2), newValue);
+	componentManager.AddComponent(entity1);
+	EXPECT_EQ(componentManager.GetAllComponents().size(), 2);
+}
+
+TEST(SparseComponent, RemoveDestroyedComponents)
+{
+	core::EntityManager entityManager;
+	SimpleSparseComponentManager componentManager(entityManager);
+
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	const auto entity3 = entityManager.CreateEntity();
+	componentManager.AddComponent(entity1);
+	componentManager.SetComponent(entity1, 1);
+	componentManager.AddComponent(entity2);
+	componentManager.SetComponent(entity2, 2);
+	componentManager.AddComponent(entity3);
+	componentManager.SetComponent(entity3, 3);
+	entityManager.DestroyEntity(entity1);
+
+	componentManager.RemoveDestroyedComponents();
+	ASSERT_EQ(componentManager.GetAllEntities().size(), 2);
+	EXPECT_EQ(componentManager.GetAllEntities()[0], entity2);
+	EXPECT_EQ(componentManager.GetAllEntities()[1], entity3);
+	EXPECT_EQ(componentManager.GetComponent(entity2), 2);
+	EXPECT_EQ(componentManager.GetComponent(entity3), 3);
+
+	// The destroyed Entity gets a new component when it is reused
+	EXPECT_EQ(entityManager.CreateEntity(), entity1);
+	componentManager.AddComponent(entity1);
+	EXPECT_EQ(componentManager.GetAllComponents().size(), 3);
+}
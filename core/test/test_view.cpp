@@ -0,0 +1,116 @@
+#include <vector>
+
+#include <engine/entity.hpp>
+
+#include <gtest/gtest.h>
+
+#include "engine/component.hpp"
+#include "engine/sparse_component.hpp"
+#include "engine/view.hpp"
+
+constexpr core::EntityMask VIEW_INT_TYPE = 2u;
+constexpr core::EntityMask VIEW_FLOAT_TYPE = 4u;
+constexpr core::EntityMask VIEW_OTHER_TYPE = 8u;
+
+class IntComponentManager : public core::ComponentManager<int, VIEW_INT_TYPE>
+{
+	using ComponentManager::ComponentManager;
+};
+
+class FloatComponentManager : public core::SparseComponentManager<float, VIEW_FLOAT_TYPE>
+{
+	using SparseComponentManager::SparseComponentManager;
+};
+
+TEST(View, ForEachMatchesAllComponents)
+{
+	core::EntityManager entityManager;
+	IntComponentManager intManager(entityManager);
+	FloatComponentManager floatManager(entityManager);
+
+	// Spans several blocks, with runs of entities that do not match
+	std::vector<core::Entity> expectedEntities;
+	for (std::size_t i = 0; i < 200; i++)
+	{
+		const auto entity = entityManager.CreateEntity();
+		if (i % 3 == 0)
+		{
+			intManager.AddComponent(entity);
+			intManager.SetComponent(entity, static_cast<int>(entity));
+		}
+		if (i % 5 == 0 || i > 150)
+		{
+			floatManager.AddComponent(entity);
+			floatManager.SetComponent(entity, static_cast<float>(entity));
+		}
+		if (i % 3 == 0 && (i % 5 == 0 || i > 150))
+		{
+			expectedEntities.push_back(entity);
+		}
+	}
+
+	std::vector<core::Entity> visitedEntities;
+	core::View view(entityManager, intManager, floatManager);
+	view.ForEach([&visitedEntities](const core::Entity entity, int& intComponent, float& floatComponent)
+	{
+		EXPECT_EQ(intComponent, static_cast<int>(entity));
+		EXPECT_EQ(floatComponent, static_cast<float>(entity));
+		intComponent = -1;
+		visitedEntities.push_back(entity);
+	});
+
+	EXPECT_EQ(visitedEntities, expectedEntities);
+	for (const auto entity : expectedEntities)
+	{
+		EXPECT_EQ(intManager.GetComponent(entity), -1);
+	}
+}
+
+TEST(View, WithAndWithout)
+{
+	core::EntityManager entityManager;
+	IntComponentManager intManager(entityManager);
+
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	const auto entity3 = entityManager.CreateEntity();
+	intManager.AddComponent(entity1);
+	intManager.AddComponent(entity2);
+	intManager.AddComponent(entity3);
+	entityManager.AddComponent(entity2, VIEW_OTHER_TYPE);
+
+	std::vector<core::Entity> visitedEntities;
+	const IntComponentManager& constIntManager = intManager;
+	core::View(entityManager, constIntManager).With(VIEW_OTHER_TYPE).ForEach(
+		[&visitedEntities](const core::Entity entity, const int&)
+		{
+			visitedEntities.push_back(entity);
+		});
+	ASSERT_EQ(visitedEntities.size(), 1);
+	EXPECT_EQ(visitedEntities[0], entity2);
+
+	visitedEntities.clear();
+	core::View(entityManager, intManager).Without(VIEW_OTHER_TYPE).ForEach(
+		[&visitedEntities](const core::Entity entity, int&)
+		{
+			visitedEntities.push_back(entity);
+		});
+	EXPECT_EQ(visitedEntities, (std::vector{entity1, entity3}));
+}
+
+TEST(View, SkipsDestroyedEntities)
+{
+	core::EntityManager entityManager;
+
+	const auto entity1 = entityManager.CreateEntity();
+	const auto entity2 = entityManager.CreateEntity();
+	entityManager.DestroyEntity(entity1);
+
+	std::vector<core::Entity> visitedEntities;
+	core::View(entityManager).ForEach([&visitedEntities](const core::Entity entity)
+	{
+		visitedEntities.push_back(entity);
+	});
+	ASSERT_EQ(visitedEntities.size(), 1);
+	EXPECT_EQ(visitedEntities[0], entity2);
+}
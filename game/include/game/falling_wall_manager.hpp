@@ -4,6 +4,7 @@
 #include "score_manager.hpp"
 
 #include "engine/component.hpp"
+#include "engine/sparse_component.hpp"
 #include "physics/event_interfaces.hpp"
 #include "game/player_character.hpp"
 
@@ -29,9 +30,10 @@ struct FallingObject
 
 /**
  * \brief Makes falling objects fall.
+ * Only the players and the falling walls fall, the components are stored in a sparse set.
  */
 class FallingObjectManager final :
-	public core::ComponentManager<FallingObject, static_cast<core::EntityMask>(ComponentType::FallingObject)>
+	public core::SparseComponentManager<FallingObject, static_cast<core::EntityMask>(ComponentType::FallingObject)>
 {
 public:
 	FallingObjectManager(core::EntityManager& entityManager, PhysicsManager& physicsManager);
@@ -85,6 +87,7 @@ public:
 
 	void FixedUpdate();
 	void CopyAllComponents(const FallingWallSpawnManager& fallingWallSpawnManager);
+	void CopyAllComponents(FallingWallSpawnInstructions nextFallingWallSpawnInstructions, bool hasSpawned);
 
 	/**
 	 * \brief Spawns a wall using the the falling wall spawn instructions.
@@ -98,6 +101,8 @@ public:
 		return _nextFallingWallSpawnInstructions;
 	}
 
+	[[nodiscard]] bool HasSpawned() const { return _hasSpawned; }
+
 private:
 	FallingWallSpawnInstructions _nextFallingWallSpawnInstructions{};
 	bool _hasSpawned = true;
@@ -42,10 +42,16 @@ constexpr float BALL_SPEED = 2.0f;
 constexpr float BALL_SCALE = 0.3f;
 
 /**
- * \brief windowBufferSize is the size of input stored by a client. 5 seconds of frame at 50 fps
+ * \brief windowBufferSize is the default size of input stored by a client. 5 seconds of frame at 50 fps
  */
 constexpr std::size_t WINDOW_BUFFER_SIZE = 5ull * 50ull;
 
+/**
+ * \brief snapshotKeyframeInterval is the number of rollback snapshots between two full copies of the world.
+ * The other snapshots only store the bytes that changed since the previous frame, restoring one applies at most this many deltas.
+ */
+constexpr std::size_t SNAPSHOT_KEYFRAME_INTERVAL = 25;
+
 /**
  * \brief startDelay is the delay to wait before starting a game in milliseconds
  */
@@ -61,6 +67,30 @@ constexpr std::size_t MAX_INPUT_NMB = 50;
  */
 constexpr float FIXED_PERIOD = 1.0f / 50.0f; //50fps
 
+/**
+ * \brief minInputDelay and maxInputDelay are the bounds in frames of the delay applied to the local inputs of a client
+ */
+constexpr Frame MIN_INPUT_DELAY = 0;
+constexpr Frame MAX_INPUT_DELAY = 5;
+
+/**
+ * \brief timeSyncMinFrameAdvantage is the number of frames a client needs to be ahead of the others to slow down,
+ * its fixed period is then stretched by timeSyncPeriodStretch until the clients are aligned
+ */
+constexpr float TIME_SYNC_MIN_FRAME_ADVANTAGE = 1.0f;
+constexpr float TIME_SYNC_PERIOD_STRETCH = 0.1f;
+
+/**
+ * \brief timeSyncSmoothing is the weight of a new frame advantage measure in its moving average
+ */
+constexpr float TIME_SYNC_SMOOTHING = 1.0f / 16.0f;
+
+/**
+ * \brief physicsSolverIterations is the number of times the impulses of the contacts of a frame are solved,
+ * it must be the same on every peer
+ */
+constexpr std::size_t PHYSICS_SOLVER_ITERATIONS = 1;
+
 
 constexpr std::array PLAYER_COLORS
 {
@@ -106,6 +136,12 @@ enum class ComponentType : core::EntityMask
 	Damager = OTHER_TYPE << 8u,
 };
 
+/**
+ * \brief Flags of the components that only the clients have to draw the entities, they are not part of the rollback world.
+ */
+constexpr core::EntityMask CLIENT_COMPONENT_MASK = static_cast<core::EntityMask>(core::ComponentType::Sprite) |
+	static_cast<core::EntityMask>(core::ComponentType::RectangleShape);
+
 constexpr unsigned WINDOW_SCALE = 60;
 const sf::Vector2u DEBUG_WINDOW_SIZE{core::WINDOW_RATIO.x * 2 * WINDOW_SCALE, core::WINDOW_RATIO.y * WINDOW_SCALE};
 const sf::Vector2u DEBUG_FRAMEBUFFER_SIZE = core::WINDOW_RATIO * WINDOW_SCALE;
@@ -1,4 +1,6 @@
 #pragma once
+#include <deque>
+
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Graphics/Texture.hpp>
@@ -30,7 +32,7 @@ class PacketSenderInterface;
 class GameManager
 {
 public:
-	GameManager();
+	explicit GameManager(RollbackMode rollbackMode = RollbackMode::Server);
 	virtual ~GameManager() = default;
 	GameManager(const GameManager& other) = delete;
 	GameManager(GameManager&& other) = delete;
@@ -105,8 +107,45 @@ public:
 	std::pair<core::Entity, core::Entity> SpawnFallingWall(float doorPosition, bool requiresBall) override;
 	void FixedUpdate();
 	void SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, std::uint32_t inputFrame) override;
+
+	/**
+	 * \brief SetLocalPlayerInput is a method that sets the input of the client player on the frame scheduled by the input delay.
+	 * While the delay shrinks, the already sent frame is kept and the input is dropped.
+	 */
+	void SetLocalPlayerInput(PlayerInput playerInput);
+
+	/**
+	 * \brief SetRoundTripTime is a method called when the smoothed round trip time to the server is updated.
+	 * The adaptive input delay hides half of it, so the remote inputs are resimulated on fewer frames.
+	 * \param srtt is the smoothed round trip time in milliseconds
+	 */
+	void SetRoundTripTime(float srtt);
+	[[nodiscard]] Frame GetInputDelay() const { return _inputDelay; }
+
+	/**
+	 * \brief UpdateFrameAdvantage is a method called when receiving the inputs of a remote player.
+	 * It measures how many frames this client is ahead of the remote one, and records how far the remote one said it is ahead.
+	 * \param playerNumber is the remote player
+	 * \param remoteFrame is the frame the remote client was playing when sending its inputs
+	 * \param remoteFrameAdvantage is the frame advantage sent by the remote client
+	 */
+	void UpdateFrameAdvantage(PlayerNumber playerNumber, Frame remoteFrame, std::int8_t remoteFrameAdvantage);
+
+	/**
+	 * \brief GetFrameAdvantage is a method that gives the number of frames this client should lose to be aligned with the others.
+	 * Each side measures its advantage with the same latency estimate, half of their difference cancels it.
+	 */
+	[[nodiscard]] float GetFrameAdvantage() const;
 	void DrawImGui() override;
-	void ConfirmValidateFrame(Frame newValidateFrame, const std::array<PhysicsState, MAX_PLAYER_NMB>& physicsStates);
+	/**
+	 * \brief ConfirmValidateFrame is a method that validates a frame and asks the server for its world when the checksums differ.
+	 */
+	void ConfirmValidateFrame(Frame newValidateFrame, WorldChecksum worldChecksum);
+
+	/**
+	 * \brief ResyncValidatedWorld is a method that is called when receiving the world asked after a checksum mismatch.
+	 */
+	void ResyncValidatedWorld(Frame newValidateFrame, const WorldBlob& world, WorldChecksum worldChecksum);
 	[[nodiscard]] PlayerNumber GetPlayerNumber() const { return _clientPlayer; }
 	void LoseGame() override;
 	[[nodiscard]] std::uint32_t GetState() const { return _state; }
@@ -129,5 +168,72 @@ protected:
 
 	sf::Text _textRenderer;
 	bool _drawPhysics = true;
+
+	/**
+	 * \brief Set when a resync was asked to the server, the following mismatches are expected until its world is received.
+	 */
+	bool _isWaitingForResync = false;
+	/**
+	 * \brief Set when a resynced world still did not match the server, asking it again would only give the same world.
+	 */
+	bool _hasResyncFailed = false;
+	std::uint32_t _resyncCount = 0;
+
+	/**
+	 * \brief Number of frames between the current frame and the frame of the local input.
+	 */
+	Frame _inputDelay = MIN_INPUT_DELAY;
+	Frame _minInputDelay = MIN_INPUT_DELAY;
+	Frame _maxInputDelay = MAX_INPUT_DELAY;
+	bool _isInputDelayAdaptive = true;
+	float _srtt = -1.0f;
+
+	Frame _localInputFrame = 0;
+	bool _isLocalInputFrameSent = false;
+
+	/**
+	 * \brief Validations of frames the client did not reach yet, the other clients send their delayed inputs ahead.
+	 */
+	std::deque<std::pair<Frame, WorldChecksum>> _pendingValidateFrames;
+
+	/**
+	 * \brief Moving averages of the frames this client is ahead of each remote client, and of the advantages they sent.
+	 */
+	std::array<float, MAX_PLAYER_NMB> _localFrameAdvantages{};
+	std::array<float, MAX_PLAYER_NMB> _remoteFrameAdvantages{};
+	bool _isTimeSyncEnabled = true;
+	bool _isTimeSyncStretching = false;
+
+	/**
+	 * \brief Transforms of the last two simulated frames, the rendered transforms are interpolated between them.
+	 */
+	std::vector<core::Vec2f> _previousPositions;
+	std::vector<core::Vec2f> _currentPositions;
+	std::vector<core::Degree> _previousRotations;
+	std::vector<core::Degree> _currentRotations;
+	std::vector<bool> _hasSimulatedTransform;
+	/**
+	 * \brief Entities with a simulated transform, and their interpolated transforms written to the rendered ones in one batch.
+	 */
+	std::vector<core::Entity> _interpolatedEntities;
+	std::vector<core::Vec2f> _interpolatedPositions;
+	std::vector<core::Degree> _interpolatedRotations;
+	Frame _sampledFrame = 0;
+	bool _isInterpolating = true;
+
+	void UpdateInputDelay();
+	void ScheduleLocalInputFrame();
+	void ConfirmPendingValidateFrames();
+
+	/**
+	 * \brief SampleSimulatedTransforms is a method that reads the transforms of the simulated frame after each rollback pass.
+	 */
+	void SampleSimulatedTransforms();
+
+	/**
+	 * \brief InterpolateTransforms is a method that sets the rendered transforms between the last two simulated frames.
+	 * \param ratio is 0 for the previous simulated frame and 1 for the current one
+	 */
+	void InterpolateTransforms(float ratio);
 };
 }
@@ -0,0 +1,114 @@
+#pragma once
+#include <array>
+#include <string_view>
+
+#include "game_globals.hpp"
+
+namespace game
+{
+/**
+ * \brief InputPredictor is an interface that predicts the inputs of a player after its last received input.
+ * The predictions are stored in the input window when a frame starts, a model that learns never changes the inputs
+ * a frame was simulated with.
+ */
+class InputPredictor
+{
+public:
+	InputPredictor() = default;
+	virtual ~InputPredictor() = default;
+	InputPredictor(const InputPredictor& other) = default;
+	InputPredictor(InputPredictor&& other) = default;
+	InputPredictor& operator=(const InputPredictor& other) = default;
+	InputPredictor& operator=(InputPredictor&& other) = default;
+
+	[[nodiscard]] virtual std::string_view GetName() const = 0;
+
+	/**
+	 * \brief PredictInput is a method that predicts the input of a player on a frame after its last received frame.
+	 * \param playerNumber is the player whose input is predicted
+	 * \param lastInput is the last received input of the player
+	 * \param frameCount is the number of frames since the last received frame, at least 1
+	 * \return the predicted input
+	 */
+	[[nodiscard]] virtual PlayerInput PredictInput(PlayerNumber playerNumber, PlayerInput lastInput,
+	                                               Frame frameCount) const = 0;
+
+	/**
+	 * \brief LearnInput is a method called with every validated input of a player, in the order of the frames.
+	 * \param playerNumber is the player of the input
+	 * \param previousInput is the input of the previous frame
+	 * \param input is the validated input
+	 */
+	virtual void LearnInput([[maybe_unused]] PlayerNumber playerNumber, [[maybe_unused]] PlayerInput previousInput,
+	                        [[maybe_unused]] PlayerInput input)
+	{
+	}
+
+	/**
+	 * \brief RecordPrediction is a method that counts if the prediction of a simulated frame was correct.
+	 */
+	void RecordPrediction(const bool isHit) { isHit ? _hitCount++ : _missCount++; }
+
+	[[nodiscard]] std::size_t GetHitCount() const { return _hitCount; }
+	[[nodiscard]] std::size_t GetMissCount() const { return _missCount; }
+
+	/**
+	 * \brief Ratio of correct predictions over all the recorded predictions, 1 if nothing was recorded yet.
+	 */
+	[[nodiscard]] float GetHitRatio() const;
+
+private:
+	std::size_t _hitCount = 0;
+	std::size_t _missCount = 0;
+};
+
+/**
+ * \brief RepeatLastInputPredictor predicts that the player keeps its last received input.
+ */
+class RepeatLastInputPredictor final : public InputPredictor
+{
+public:
+	[[nodiscard]] std::string_view GetName() const override { return "Repeat Last"; }
+	[[nodiscard]] PlayerInput PredictInput(PlayerNumber playerNumber, PlayerInput lastInput,
+	                                       Frame frameCount) const override;
+};
+
+/**
+ * \brief MarkovInputPredictor predicts the most frequent transition from the last input, learned per player.
+ * The counts of an input are halved when one of them saturates, so recent transitions weigh more.
+ */
+class MarkovInputPredictor final : public InputPredictor
+{
+public:
+	[[nodiscard]] std::string_view GetName() const override { return "Markov"; }
+	[[nodiscard]] PlayerInput PredictInput(PlayerNumber playerNumber, PlayerInput lastInput,
+	                                       Frame frameCount) const override;
+	void LearnInput(PlayerNumber playerNumber, PlayerInput previousInput, PlayerInput input) override;
+
+private:
+	[[nodiscard]] PlayerInput GetMostLikelyInput(PlayerNumber playerNumber, PlayerInput input) const;
+
+	static constexpr std::size_t INPUT_NMB = 1u << 5u;
+	using TransitionCounts = std::array<std::array<std::uint8_t, INPUT_NMB>, INPUT_NMB>;
+	std::array<TransitionCounts, MAX_PLAYER_NMB> _transitionCounts{};
+};
+
+/**
+ * \brief ShootReleaseInputPredictor repeats the last input, but predicts that Shoot is released after some frames.
+ */
+class ShootReleaseInputPredictor final : public InputPredictor
+{
+public:
+	explicit ShootReleaseInputPredictor(const Frame releaseFrameCount = 3u)
+		: _releaseFrameCount(releaseFrameCount)
+	{
+	}
+
+	[[nodiscard]] std::string_view GetName() const override { return "Release Shoot"; }
+	[[nodiscard]] PlayerInput PredictInput(PlayerNumber playerNumber, PlayerInput lastInput,
+	                                       Frame frameCount) const override;
+
+private:
+	Frame _releaseFrameCount;
+};
+}
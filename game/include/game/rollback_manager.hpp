@@ -1,7 +1,10 @@
 #pragma once
+#include <memory>
+
 #include "ball_manager.hpp"
 #include "falling_wall_manager.hpp"
 #include "game_globals.hpp"
+#include "input_predictor.hpp"
 #include "player_character.hpp"
 
 #include "engine/entity.hpp"
@@ -12,10 +15,13 @@
 #include "physics/physics_manager.hpp"
 #include "damage_manager.hpp"
 #include "score_manager.hpp"
+#include "world_blob.hpp"
+#include "world_checksum.hpp"
 
 namespace game
 {
 class GameManager;
+class SpeculativeResimulation;
 
 /**
  * \brief CreatedEntity is a struct that contains information on the newly created entities.
@@ -27,15 +33,80 @@ struct CreatedEntity
 	Frame createdFrame = 0;
 };
 
+/**
+ * \brief DestroyedEntity is a struct that contains information on the entities flagged as DESTROY.
+ * It is used by the RollbackManager to remove the flags when going back in time and to truly destroy the entities
+ * when their frame is validated.
+ */
+struct DestroyedEntity
+{
+	core::Entity entity = core::INVALID_ENTITY;
+	Frame destroyedFrame = 0;
+};
+
+/**
+ * \brief FramePrediction is whether a frame of the window was simulated with predicted inputs, and whether one of them
+ * was wrong. It is counted as a prediction hit or miss when the frame is validated.
+ */
+enum class FramePrediction : std::uint8_t
+{
+	None,
+	Predicted,
+	Mispredicted,
+};
+
+/**
+ * \brief WorldHeader is the fixed size part of a serialized world, written at the start of its WorldBlob.
+ * It is followed by the destroyed entities and the component arrays.
+ */
+struct WorldHeader
+{
+	FallingWallSpawnInstructions fallingWallSpawnInstructions{};
+	bool hasFallingWallSpawned = true;
+	ScoreManager scoreManager{};
+};
+
+/**
+ * \brief WorldSnapshot is the stored world of a simulated frame of the window.
+ * Keyframes keep the whole serialized world, the other frames only the bytes that changed since the previous frame.
+ * The header is kept aside, so it can be patched without rebuilding the following deltas.
+ */
+struct WorldSnapshot
+{
+	WorldHeader header{};
+	WorldBlob keyframe;
+	std::vector<std::uint8_t> delta;
+	std::size_t worldSize = 0;
+	bool isKeyframe = false;
+	WorldChecksum checksum = 0;
+};
+
+/**
+ * \brief RollbackMode tells how the RollbackManager advances its world.
+ * Client predicts the missing inputs and rolls back on mispredictions, it keeps snapshots of the window.
+ * Server only advances the authoritative world over the newly validated frames, it never restores nor keeps snapshots.
+ */
+enum class RollbackMode : std::uint8_t
+{
+	Client,
+	Server,
+};
+
 /**
  * \brief RollbackManager is a class that manages all the rollback mechanisms of the game.
- * It contains two copies of the world (PhysicsManager, TransformManager, etc...), the current one and the validated one.
+ * It contains the current world (PhysicsManager, TransformManager, etc...) and serialized copies of the validated world
+ * and of every simulated frame of the window.
  * When receiving new information, it can re-update the current copy of the world.
  */
 class RollbackManager final : public OnTriggerInterface, OnCollisionInterface
 {
 public:
-	RollbackManager(GameManager& gameManager, core::EntityManager& entityManager);
+	RollbackManager(GameManager& gameManager, core::EntityManager& entityManager, RollbackMode rollbackMode);
+	~RollbackManager() override;
+	RollbackManager(const RollbackManager& other) = delete;
+	RollbackManager(RollbackManager&& other) = delete;
+	RollbackManager& operator=(const RollbackManager& other) = delete;
+	RollbackManager& operator=(RollbackManager&& other) = delete;
 
 	/**
 	 * \brief SimulateToCurrentFrame is a method that simulates all players with new inputs, method call only by the clients to update the current state of the visuals
@@ -45,6 +116,7 @@ public:
 	/**
 	 * \brief SetPlayerInput is a method that set the input of a certain player on a certain game frame.
 	 * It can change an input between the last validated frame and the current frame.
+	 * If the new input differs from the predicted one, the frame is marked as the first one to resimulate.
 	 * It is called by the GameManager when receiving new inputs from packets.
 	 * \param playerNumber is the player number whose input will change
 	 * \param playerInput is the new input
@@ -56,27 +128,126 @@ public:
 	/**
 	 * \brief ValidateFrame is a method that validates all the frames from lastValidateFrame_ to newValidateFrame.
 	 * It changes lastValidateFrame_ to be newValidateFrame.
+	 * In server mode, the current world is simulated forward over the new validated frames and becomes the validated world.
 	 * \param newValidateFrame is the new value of lastValidateFrame_
 	 */
 	void ValidateFrame(Frame newValidateFrame);
 
 	/**
-	 * \brief ConfirmFrame is a method that confirms the new validate frame by checking the Physics State checksum
+	 * \brief ConfirmFrame is a method that confirms the new validate frame by checking the world checksum
 	 * It is called by the clients when receiving Confirm Frame packet
 	 * \param newValidatedFrame is the new frame that is validated
-	 * \param serverPhysicsState is the physics state given by the server through a packet
+	 * \param serverChecksum is the checksum of the validated world given by the server through a packet
+	 * \return false if the validated world of the client differs from the server one and needs a resync
 	 */
-	void ConfirmFrame(Frame newValidatedFrame, const std::array<PhysicsState, MAX_PLAYER_NMB>& serverPhysicsState);
+	bool ConfirmFrame(Frame newValidatedFrame, WorldChecksum serverChecksum);
 
-	[[nodiscard]] PhysicsState GetValidatePhysicsState(PlayerNumber playerNumber) const;
+	/**
+	 * \brief WriteValidatedWorld is a method that serializes the last validated world, to send it to a desynced client.
+	 * The entity masks are written after the world, followed by the size of the world, so the client gets the entities
+	 * caught or spawned only on the server.
+	 * Only the server can write it, the entity masks of the clients are not the ones of their validated world.
+	 * \param world is the blob that is overwritten
+	 */
+	void WriteValidatedWorld(WorldBlob& world) const;
+
+	/**
+	 * \brief ResyncValidatedWorld is a method that replaces the validated world of a client by the world of the server.
+	 * The entity masks of the server replace the ones of the client, keeping the flags of the client only components.
+	 * The frames after it are then resimulated from the new validated world.
+	 * \param newValidateFrame is the frame of the server world, it cannot be older than the last validated frame
+	 * \param world is the serialized world of the server, followed by its entity masks
+	 * \param serverChecksum is the checksum of the server world
+	 * \return false if the world could not be installed or still does not give the server checksum
+	 */
+	bool ResyncValidatedWorld(Frame newValidateFrame, const WorldBlob& world, WorldChecksum serverChecksum);
+
+	/**
+	 * \brief GetValidateChecksum is a method that gives the checksum of the last validated world.
+	 * It is computed once per simulated frame, so it is only read when validating.
+	 */
+	[[nodiscard]] WorldChecksum GetValidateChecksum() const { return _lastValidateChecksum; }
 	[[nodiscard]] Frame GetLastValidateFrame() const { return _lastValidateFrame; }
 
+	/**
+	 * \brief GetValidatedWorld is a method that gives the serialized last validated world.
+	 * Its bytes can be sent or recorded as is. It is not kept up to date in server mode.
+	 */
+	[[nodiscard]] const WorldBlob& GetValidatedWorld() const { return _lastValidateWorld; }
+
 	[[nodiscard]] Frame GetLastReceivedFrame(const PlayerNumber playerNumber) const
 	{
 		return _lastReceivedFrame[playerNumber];
 	}
 
 	[[nodiscard]] Frame GetCurrentFrame() const { return _currentFrame; }
+	[[nodiscard]] Frame GetTestedFrame() const { return _testedFrame; }
+	[[nodiscard]] RollbackMode GetRollbackMode() const { return _rollbackMode; }
+
+	/**
+	 * \brief Number of validated frames that were simulated with predicted inputs which were all correct.
+	 */
+	[[nodiscard]] std::size_t GetPredictionHitCount() const { return _predictionHitCount; }
+
+	/**
+	 * \brief Number of validated frames that were simulated with a wrong predicted input and needed a resimulation.
+	 * The frames replaced by a resync are not counted.
+	 */
+	[[nodiscard]] std::size_t GetPredictionMissCount() const { return _predictionMissCount; }
+
+	/**
+	 * \brief Ratio of prediction hits over all the validated frames simulated with predictions, 1 if there were none yet.
+	 */
+	[[nodiscard]] float GetPredictionHitRatio() const;
+
+	/**
+	 * \brief Number of already simulated frames thrown away by the last rollback, and the maximum over the game.
+	 */
+	[[nodiscard]] Frame GetRollbackDepth() const { return _rollbackDepth; }
+	[[nodiscard]] Frame GetMaxRollbackDepth() const { return _maxRollbackDepth; }
+
+	/**
+	 * \brief AddInputPredictor is a method that adds a model predicting the inputs after the last received ones.
+	 * Every model records its hit rate on the received inputs, only the active one is used for the simulation.
+	 * \param inputPredictor is the new model
+	 * \return the index of the model
+	 */
+	std::size_t AddInputPredictor(std::unique_ptr<InputPredictor> inputPredictor);
+
+	/**
+	 * \brief SetActiveInputPredictor is a method that chooses the model used to predict the inputs of the next frames.
+	 * \param index is the index of the model given by AddInputPredictor
+	 */
+	void SetActiveInputPredictor(std::size_t index);
+	[[nodiscard]] std::size_t GetActiveInputPredictor() const { return _activeInputPredictor; }
+
+	[[nodiscard]] const std::vector<std::unique_ptr<InputPredictor>>& GetInputPredictors() const
+	{
+		return _inputPredictors;
+	}
+
+	/**
+	 * \brief SetSpeculationHypothesisCount is a method that enables the speculative resimulation of the clients.
+	 * Alternative inputs of the remote player are simulated on worker threads, when the received inputs match one of them,
+	 * its frames are swapped in instead of being resimulated.
+	 * \param hypothesisCount is the number of alternative inputs simulated at the same time, 0 disables it
+	 */
+	void SetSpeculationHypothesisCount(std::size_t hypothesisCount);
+	[[nodiscard]] std::size_t GetSpeculationHypothesisCount() const;
+
+	/**
+	 * \brief Number of mispredictions that were repaired with the frames of a speculative timeline.
+	 */
+	[[nodiscard]] std::size_t GetSpeculationHitCount() const { return _speculationHitCount; }
+
+	/**
+	 * \brief SetIncrementalRestore is a method that enables the incremental restore of the client.
+	 * The managers track the components that may be modified, and restoring a frame only copies these components back
+	 * from its snapshot instead of the whole arrays.
+	 * \param isIncrementalRestore is true to restore incrementally
+	 */
+	void SetIncrementalRestore(bool isIncrementalRestore);
+	[[nodiscard]] bool IsIncrementalRestore() const { return _isIncrementalRestore; }
 	[[nodiscard]] const core::TransformManager& GetTransformManager() const { return _currentTransformManager; }
 	[[nodiscard]] const PlayerCharacterManager& GetPlayerCharacterManager() const { return _currentPlayerManager; }
 	[[nodiscard]] const ScoreManager& GetScoreManager() const { return _currentScoreManager; }
@@ -91,6 +262,7 @@ public:
 	/**
 	 * \brief DestroyEntity is a method that does not destroy the entity definitely, but puts the DESTROY flag on.
 	 * An entity is truly destroyed when the destroy frame is validated.
+	 * Entities created in the window are flagged too, as older snapshots still need them alive.
 	 * \param entity is the entity to be "destroyed"
 	 */
 	void DestroyEntity(core::Entity entity);
@@ -98,22 +270,26 @@ public:
 	void OnTrigger(core::Entity entity1, core::Entity entity2) override;
 	void OnCollision(core::Entity entity1, core::Entity entity2) override;
 
-	[[nodiscard]] const std::array<PlayerInput, WINDOW_BUFFER_SIZE>& GetInputs(const PlayerNumber playerNumber) const
-	{
-		return _inputs[playerNumber];
-	}
+	/**
+	 * \brief GetInputAtFrame is a method that gets the input of a player on a frame of the window.
+	 * Frames after the last received frame of the player return the input predicted when the frame started.
+	 * \param playerNumber is the player whose input is read
+	 * \param frame is the game frame, between currentFrame - windowSize (excluded) and currentFrame
+	 * \return the received or predicted input
+	 */
+	[[nodiscard]] PlayerInput GetInputAtFrame(PlayerNumber playerNumber, Frame frame) const;
 
-	PhysicsManager& GetCurrentPhysicsManager() { return _currentPhysicsManager; }
+	/**
+	 * \brief SetWindowSize is a method that changes the number of frames stored for rollback.
+	 * It must be called before the game starts, as it clears the stored inputs and snapshots.
+	 * \param windowSize is the new number of frames, at least MAX_INPUT_NMB
+	 */
+	void SetWindowSize(std::size_t windowSize);
+	[[nodiscard]] std::size_t GetWindowSize() const { return _windowSize; }
 
-	bool SetNextFallingWallSpawnInstructions(const FallingWallSpawnInstructions fallingWallSpawnInstructions)
-	{
-		const bool currentResult = _currentFallingWallSpawnManager.SetNextFallingWallSpawnInstructions(
-			fallingWallSpawnInstructions);
-		const bool lastValidateResult = _lastValidateFallingWallSpawnManager.SetNextFallingWallSpawnInstructions(
-			fallingWallSpawnInstructions);
+	PhysicsManager& GetCurrentPhysicsManager() { return _currentPhysicsManager; }
 
-		return lastValidateResult && currentResult;
-	}
+	bool SetNextFallingWallSpawnInstructions(FallingWallSpawnInstructions fallingWallSpawnInstructions);
 
 	[[nodiscard]] FallingWallSpawnInstructions GetNextFallingWallSpawnInstructions() const
 	{
@@ -121,10 +297,145 @@ public:
 	}
 
 private:
-	[[nodiscard]] PlayerInput GetInputAtFrame(PlayerNumber playerNumber, Frame frame) const;
+	/**
+	 * \brief SimulateToFrame is a method that brings the current world to the state of targetFrame.
+	 * It restores the snapshot of the last correctly simulated frame and resimulates only the frames after it.
+	 * \param targetFrame is the frame the current world will be at
+	 */
+	void SimulateToFrame(Frame targetFrame);
+
+	/**
+	 * \brief SimulateFrame is a method that copies the inputs of a frame into the player manager and simulates it once.
+	 * \param frame is the simulated frame
+	 */
+	void SimulateFrame(Frame frame);
+
+	/**
+	 * \brief RestoreFrame is a method that reverts the current world to its state at the end of the given frame.
+	 * The last validated frame is restored from the validated world, later frames from their snapshot.
+	 * \param frame is the frame to restore, between the last validated frame and the last simulated frame
+	 */
+	void RestoreFrame(Frame frame);
+
+	/**
+	 * \brief SaveWorld is a method that serializes the current world.
+	 * \param world is the blob that is overwritten
+	 */
+	void SaveWorld(WorldBlob& world) const;
+
+	/**
+	 * \brief LoadWorld is a method that overwrites the current world with a serialized one.
+	 * The DESTROY flags must already be removed, the ones of the serialized world are put back.
+	 * \param world is the blob to read
+	 */
+	void LoadWorld(const WorldBlob& world);
+
+	/**
+	 * \brief LoadDirtyWorld is a method that overwrites the current world with a serialized one, like LoadWorld,
+	 * but only copies back the dirty components. The other components were not modified since the frame of the
+	 * dirty flags, which must not be after the frame of the serialized world.
+	 * \param world is the blob to read
+	 */
+	void LoadDirtyWorld(const WorldBlob& world);
+
+	/**
+	 * \brief LoadWorldHeader is a method that reads the values of the serialized world that are not component arrays.
+	 * \return the offset of the first component array
+	 */
+	std::size_t LoadWorldHeader(const WorldBlob& world);
+
+	/**
+	 * \brief ClearDirty is a method that clears the dirty flags of all the managers, when they hold a loaded world.
+	 * \param frame is the frame of the loaded world
+	 */
+	void ClearDirty(Frame frame);
+
+	/**
+	 * \brief SaveSnapshot is a method that serializes the current world and stores it in the snapshot of the given frame,
+	 * as a keyframe or as a delta against the previous frame.
+	 * \param frame is the frame that was just simulated
+	 */
+	void SaveSnapshot(Frame frame);
+
+	/**
+	 * \brief LoadSnapshot is a method that rebuilds the whole serialized world of a frame of the window.
+	 * It starts from the closest previous keyframe, or the validated world, and applies the following deltas.
+	 * \param frame is the frame to rebuild, between the last validated frame and the last simulated frame
+	 * \param world is the blob that is overwritten, it can be the validated world
+	 */
+	void LoadSnapshot(Frame frame, WorldBlob& world);
+
+	/**
+	 * \brief RestoreEntities is a method that destroys the entities created after a frame and removes the DESTROY flags,
+	 * before a world of this frame or a later one is loaded.
+	 */
+	void RestoreEntities(Frame frame);
+
+	/**
+	 * \brief DestroyValidatedEntity is a method that truly destroys an Entity whose destroy frame is validated.
+	 * Its falling object is removed first, so the sparse set only holds the entities owning the component.
+	 */
+	void DestroyValidatedEntity(core::Entity entity);
+
+	/**
+	 * \brief ComputeChecksum is a method that hashes the rollback state of all the alive entities of the current world.
+	 * The falling wall spawn instructions and their spawned flag are not part of it, they are patched by the clients
+	 * when they are received and by the server when it sends them.
+	 */
+	[[nodiscard]] WorldChecksum ComputeChecksum() const;
+
+	/**
+	 * \brief SaveValidatedWorld is a method that stores the current world as the validated world.
+	 * It is used when entities are added outside of the simulation, before the game starts.
+	 */
+	void SaveValidatedWorld();
+
+	/**
+	 * \brief SetFallingWallSpawnInstructions is a method that gives the next falling wall instructions to a serialized world
+	 * whose last falling wall has already spawned.
+	 * \return false if the falling wall of the serialized world has not spawned yet
+	 */
+	static bool SetFallingWallSpawnInstructions(WorldBlob& world,
+	                                            FallingWallSpawnInstructions fallingWallSpawnInstructions);
+	static bool SetFallingWallSpawnInstructions(WorldHeader& header,
+	                                            FallingWallSpawnInstructions fallingWallSpawnInstructions);
+
+	/**
+	 * \brief AdvanceValidatedWorld is a method used in server mode that simulates the current world
+	 * until the new validated frame and definitely destroys the DESTROY entities.
+	 * \param newValidateFrame is the new last validated frame
+	 */
+	void AdvanceValidatedWorld(Frame newValidateFrame);
+
+	/**
+	 * \brief MarkMispredictedFrame is a method that lowers the last correctly simulated frame
+	 * when an input that differs from the prediction is received, and counts the frame as mispredicted if it was simulated.
+	 * \param frame is the frame whose input changed
+	 */
+	void MarkMispredictedFrame(Frame frame);
+
+	/**
+	 * \brief StartSpeculation is a method that launches the speculative timelines from the last frame of the
+	 * remote player inputs to the current frame, when the previous ones are finished.
+	 */
+	void StartSpeculation();
+
+	/**
+	 * \brief ApplySpeculation is a method that replaces the mispredicted frames by the ones of the speculative timeline
+	 * whose remote input matches the received inputs. The timeline must not have created or destroyed entities.
+	 * \param targetFrame is the frame the world is simulated to
+	 */
+	void ApplySpeculation(Frame targetFrame);
+
+	[[nodiscard]] WorldSnapshot& GetSnapshot(const Frame frame) { return _snapshots[frame % _windowSize]; }
+	[[nodiscard]] PlayerInput& GetInputSlot(const PlayerNumber playerNumber, const Frame frame)
+	{
+		return _inputs[playerNumber][frame % _windowSize];
+	}
 
 	GameManager& _gameManager;
 	core::EntityManager& _entityManager;
+	RollbackMode _rollbackMode;
 
 	/**
 	 * \brief Used for rendering
@@ -140,16 +451,20 @@ private:
 	ScoreManager _currentScoreManager{};
 
 	/**
-	 * Last Validate (confirm frame) Component Managers used for rollback
+	 * \brief Serialized world at the last validated (confirm) frame, used for rollback
 	 */
-	PhysicsManager _lastValidatePhysicsManager;
-	PlayerCharacterManager _lastValidatePlayerManager;
-	BallManager _lastValidateBulletManager;
-	FallingObjectManager _lastValidateFallingObjectManager;
-	FallingDoorManager _lastValidateFallingDoorManager;
-	DamageManager _lastValidateDamageManager;
-	FallingWallSpawnManager _lastValidateFallingWallSpawnManager;
-	ScoreManager _lastValidateScoreManager{};
+	WorldBlob _lastValidateWorld;
+	WorldChecksum _lastValidateChecksum = 0;
+
+	/**
+	 * \brief Serialized current world at currentWorldFrame_, the next snapshot delta is computed against it.
+	 */
+	WorldBlob _currentWorld;
+
+	/**
+	 * \brief Used to serialize the current world before it replaces currentWorld_.
+	 */
+	WorldBlob _savedWorld;
 
 	/**
 	 * \brief lastValidateFrame_ is the last validated frame from the server side.
@@ -166,13 +481,83 @@ private:
 	 */
 	Frame _testedFrame = 0;
 
+	/**
+	 * \brief lastSimulatedFrame_ is the last frame whose snapshot was simulated with the current inputs.
+	 * Everything after it needs to be resimulated.
+	 */
+	Frame _lastSimulatedFrame = 0;
+
+	/**
+	 * \brief currentWorldFrame_ is the frame whose state is held by the current managers.
+	 * When it is equal to lastSimulatedFrame_, the predictions were correct and the world does not need a restore.
+	 */
+	Frame _currentWorldFrame = 0;
+
+	std::size_t _predictionHitCount = 0;
+	std::size_t _predictionMissCount = 0;
+	Frame _rollbackDepth = 0;
+	Frame _maxRollbackDepth = 0;
+	std::size_t _speculationHitCount = 0;
+
+	bool _isIncrementalRestore = false;
+	/**
+	 * \brief dirtyFrame_ is the frame of the world the managers held when the dirty flags were cleared.
+	 * A frame before it cannot be restored incrementally, its modified components were not tracked.
+	 */
+	Frame _dirtyFrame = 0;
+
+	/**
+	 * \brief Models predicting the inputs after the last received ones, the active one fills the new frames.
+	 */
+	std::vector<std::unique_ptr<InputPredictor>> _inputPredictors;
+	std::size_t _activeInputPredictor = 0;
+
+	/**
+	 * \brief Speculative timelines of the client, null when disabled.
+	 */
+	std::unique_ptr<SpeculativeResimulation> _speculation;
+
+	/**
+	 * \brief Snapshots of the world for every frame of the window, indexed by frame modulo the window size.
+	 * Only the frames between lastValidateFrame_ (excluded) and lastSimulatedFrame_ are valid.
+	 */
+	std::vector<WorldSnapshot> _snapshots;
+
+	/**
+	 * \brief Predictions of the frames of the window, indexed by frame modulo the window size.
+	 */
+	std::vector<FramePrediction> _framePredictions;
+
+	/**
+	 * \brief windowSize_ is the number of frames stored in the inputs and snapshots circular buffers.
+	 */
+	std::size_t _windowSize = WINDOW_BUFFER_SIZE;
+
 	std::array<std::uint32_t, MAX_PLAYER_NMB> _lastReceivedFrame{};
-	std::array<std::array<PlayerInput, WINDOW_BUFFER_SIZE>, MAX_PLAYER_NMB> _inputs{};
+
+	/**
+	 * \brief Received inputs of every player, indexed by frame modulo the window size.
+	 * Only the frames until the last received frame of the player are stored, the following ones are predicted.
+	 */
+	std::array<std::vector<PlayerInput>, MAX_PLAYER_NMB> _inputs{};
 
 	/**
 	 * \brief Array containing all the created entities in the window between the confirm frame and the current frame
 	 * to destroy them when doing a rollback.
 	 */
 	std::vector<CreatedEntity> _createdEntities;
+
+	/**
+	 * \brief Array containing all the entities flagged as DESTROY in the current world, so the rollback bookkeeping
+	 * does not scan every entity.
+	 */
+	std::vector<DestroyedEntity> _destroyedEntities;
+
+	/**
+	 * \brief Physics states gathered after a simulation, copied to the transforms in one batch.
+	 */
+	std::vector<core::Entity> _syncedEntities;
+	std::vector<core::Vec2f> _syncedPositions;
+	std::vector<core::Degree> _syncedRotations;
 };
 }
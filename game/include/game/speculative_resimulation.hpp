@@ -0,0 +1,84 @@
+#pragma once
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "game_manager.hpp"
+
+namespace game
+{
+/**
+ * \brief SpeculativeGameManager is a GameManager without graphics that simulates an alternative timeline on a worker thread.
+ * It only touches its own entities and managers, its world is copied from the client before each speculation.
+ */
+class SpeculativeGameManager final : public GameManager
+{
+public:
+	SpeculativeGameManager()
+		: GameManager(RollbackMode::Client)
+	{
+	}
+
+	void SetPlayerEntities(const std::array<core::Entity, MAX_PLAYER_NMB>& playerEntityMap)
+	{
+		_playerEntityMap = playerEntityMap;
+	}
+};
+
+/**
+ * \brief SpeculativeHypothesis is a timeline where the remote player keeps an input different from its last received one.
+ */
+struct SpeculativeHypothesis
+{
+	std::unique_ptr<SpeculativeGameManager> gameManager;
+	PlayerInput remoteInput = 0u;
+	std::size_t baseDestroyedCount = 0;
+
+	/**
+	 * \brief Declared last so it is waited for before the game manager it simulates is destroyed.
+	 */
+	std::future<void> job;
+};
+
+/**
+ * \brief SpeculativeResimulation holds the alternative timelines simulated by a client on worker threads.
+ * Every timeline starts from the last frame with all the inputs and simulates until the current frame.
+ * The RollbackManager prepares them and swaps in the frames of the one that matches the received inputs.
+ */
+class SpeculativeResimulation
+{
+public:
+	SpeculativeResimulation(std::size_t hypothesisCount, std::size_t windowSize);
+
+	/**
+	 * \brief GetRemoteInput is a method that gives the input of a hypothesis.
+	 * The most likely changes of input are tried first, one pressed or released key, then two.
+	 * \param lastInput is the last received input of the remote player
+	 * \param hypothesisIndex is the index of the hypothesis
+	 */
+	[[nodiscard]] static PlayerInput GetRemoteInput(PlayerInput lastInput, std::size_t hypothesisIndex);
+
+	/**
+	 * \brief Start is a method that records the frames of the timelines, their jobs are then launched by the RollbackManager.
+	 */
+	void Start(Frame baseFrame, Frame targetFrame);
+
+	/**
+	 * \brief Invalidate is a method that discards the timelines, when the world they started from changed.
+	 */
+	void Invalidate() { _hasResults = false; }
+
+	[[nodiscard]] bool IsRunning() const;
+	[[nodiscard]] bool HasResults() const { return _hasResults && !IsRunning(); }
+
+	[[nodiscard]] Frame GetBaseFrame() const { return _baseFrame; }
+	[[nodiscard]] Frame GetTargetFrame() const { return _targetFrame; }
+	[[nodiscard]] std::vector<SpeculativeHypothesis>& GetHypotheses() { return _hypotheses; }
+
+private:
+	std::vector<SpeculativeHypothesis> _hypotheses;
+	Frame _baseFrame = 0;
+	Frame _targetFrame = 0;
+	bool _hasResults = false;
+};
+}
@@ -0,0 +1,194 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "utils/assert.hpp"
+
+namespace game
+{
+/**
+ * \brief WorldBlob is a contiguous byte buffer that holds a serialized copy of the rollback-relevant game world.
+ * Values and component arrays are written one after the other with memcpy and must be read back in the same order.
+ * The buffer is never shrunk, so saving a world of the same size again does not allocate.
+ * Its bytes can be stored or sent as is, which makes it usable for snapshots, resync and replays.
+ */
+class WorldBlob
+{
+public:
+	/**
+	 * \brief Clear is a method that empties the blob while keeping its allocated buffer.
+	 */
+	void Clear() { _size = 0; }
+
+	/**
+	 * \brief Assign is a method that replaces the content of the blob with raw serialized bytes.
+	 * \param data is the start of the serialized bytes
+	 * \param size is the number of bytes
+	 */
+	void Assign(const std::uint8_t* data, std::size_t size);
+
+	[[nodiscard]] const std::uint8_t* GetData() const { return _data.data(); }
+	[[nodiscard]] std::size_t GetSize() const { return _size; }
+
+	template <typename T>
+	void Write(const T& value);
+
+	/**
+	 * \brief Write is a method that appends the number of components followed by all the components in one copy.
+	 * \param values is the component array to write
+	 */
+	template <typename T>
+	void Write(const std::vector<T>& values);
+
+	/**
+	 * \brief Overwrite is a method that replaces an already written value, used to patch the header of a stored world.
+	 * \param offset is the position of the value in the blob
+	 * \param value is the new value
+	 */
+	template <typename T>
+	void Overwrite(std::size_t offset, const T& value);
+
+	template <typename T>
+	[[nodiscard]] T Read(std::size_t& offset) const;
+
+	/**
+	 * \brief ReadCount is a method that reads the number of components of the next array.
+	 * The destination is then resized to this count and filled with Read.
+	 */
+	[[nodiscard]] std::size_t ReadCount(std::size_t& offset) const { return Read<std::uint32_t>(offset); }
+
+	template <typename T>
+	void Read(std::size_t& offset, std::span<T> values) const;
+
+	/**
+	 * \brief ReadElement is a method that reads a single component of an array without reading the whole array.
+	 * \param offset is the position of the array in the blob
+	 * \param index is the index of the component in the array
+	 */
+	template <typename T>
+	[[nodiscard]] T ReadElement(std::size_t offset, std::size_t index) const;
+
+	/**
+	 * \brief Skip is a method that moves the offset after an array of trivially copyable values.
+	 */
+	template <typename T>
+	void Skip(std::size_t& offset) const;
+
+	/**
+	 * \brief ReadElements is a method that gives access to the elements of an array by index, without reading the
+	 * whole array, and moves the offset after the array.
+	 * \return a function reading the element of an index, or a default value after the end of the array
+	 */
+	template <typename T>
+	[[nodiscard]] auto ReadElements(std::size_t& offset) const;
+
+	/**
+	 * \brief WriteDelta is a method that stores the byte runs that differ from a base blob.
+	 * Each run is written as its offset, its length and the new bytes, close runs are merged.
+	 * \param base is the blob the delta is computed against
+	 * \param startOffset is the first compared byte, the bytes before it are ignored
+	 * \param delta is overwritten with the runs
+	 */
+	void WriteDelta(const WorldBlob& base, std::size_t startOffset, std::vector<std::uint8_t>& delta) const;
+
+	/**
+	 * \brief ApplyDelta is a method that turns the base blob of a delta into the blob the delta was computed from.
+	 * \param delta is the runs written by WriteDelta
+	 * \param size is the size of the blob the delta was computed from
+	 */
+	void ApplyDelta(const std::vector<std::uint8_t>& delta, std::size_t size);
+
+	/**
+	 * \brief Compress is a method that run-length encodes the blob, to send a whole world over the network.
+	 * The component arrays contain long runs of zeros for the unused entities.
+	 * \param compressed is overwritten with the encoded bytes
+	 */
+	void Compress(std::vector<std::uint8_t>& compressed) const;
+
+	/**
+	 * \brief Decompress is a method that replaces the content of the blob with bytes encoded by Compress.
+	 * \param compressed is the encoded bytes
+	 * \param size is the size of the blob before compression
+	 * \return false if the encoded bytes do not decode to the given size
+	 */
+	bool Decompress(const std::vector<std::uint8_t>& compressed, std::size_t size);
+
+private:
+	void Resize(std::size_t size);
+	void WriteBytes(const void* data, std::size_t size);
+	void ReadBytes(std::size_t& offset, void* data, std::size_t size) const;
+
+	std::vector<std::uint8_t> _data;
+	std::size_t _size = 0;
+};
+
+template <typename T>
+void WorldBlob::Write(const T& value)
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written in a WorldBlob");
+	WriteBytes(&value, sizeof(T));
+}
+
+template <typename T>
+void WorldBlob::Write(const std::vector<T>& values)
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written in a WorldBlob");
+	Write(static_cast<std::uint32_t>(values.size()));
+	WriteBytes(values.data(), values.size() * sizeof(T));
+}
+
+template <typename T>
+void WorldBlob::Overwrite(const std::size_t offset, const T& value)
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written in a WorldBlob");
+	gpr_assert(offset + sizeof(T) <= _size, "Overwriting outside of the WorldBlob");
+	std::memcpy(_data.data() + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T WorldBlob::Read(std::size_t& offset) const
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read from a WorldBlob");
+	T value;
+	ReadBytes(offset, &value, sizeof(T));
+	return value;
+}
+
+template <typename T>
+void WorldBlob::Read(std::size_t& offset, std::span<T> values) const
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read from a WorldBlob");
+	ReadBytes(offset, values.data(), values.size_bytes());
+}
+
+template <typename T>
+T WorldBlob::ReadElement(std::size_t offset, const std::size_t index) const
+{
+	const std::size_t count = ReadCount(offset);
+	gpr_assert(index < count, "Reading an element outside of the array");
+	offset += index * sizeof(T);
+	return Read<T>(offset);
+}
+
+template <typename T>
+void WorldBlob::Skip(std::size_t& offset) const
+{
+	const std::size_t count = ReadCount(offset);
+	offset += count * sizeof(T);
+}
+
+template <typename T>
+auto WorldBlob::ReadElements(std::size_t& offset) const
+{
+	const std::size_t arrayOffset = offset;
+	const std::size_t count = ReadCount(offset);
+	offset += count * sizeof(T);
+	return [this, arrayOffset, count](const std::size_t index)
+	{
+		return index < count ? ReadElement<T>(arrayOffset, index) : T{};
+	};
+}
+}
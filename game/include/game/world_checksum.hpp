@@ -0,0 +1,74 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+#include "maths/angle.hpp"
+#include "maths/vec2.hpp"
+
+namespace game
+{
+/**
+ * \brief WorldChecksum is the type of the checksum of the rollback world, compared between the server and the clients.
+ */
+using WorldChecksum = std::uint64_t;
+
+/**
+ * \brief WorldChecksumBuilder is a class that hashes the values of the rollback world one after the other.
+ * Only scalar values are added, so the padding bytes of the components never change the checksum.
+ * Each added value depends on the previous one, several builders are combined to hash independent arrays.
+ */
+class WorldChecksumBuilder
+{
+public:
+	template <typename T>
+	void Add(T value);
+
+	void Add(const core::Vec2f value)
+	{
+		Add(value.x);
+		Add(value.y);
+	}
+
+	void Add(const core::Radian value) { Add(value.Value()); }
+
+	/**
+	 * \brief Combine is a method that adds the checksum of another builder.
+	 * Builders hashing independent arrays are combined at the end, so their chains of multiplications run in parallel.
+	 */
+	void Combine(const WorldChecksumBuilder& other) { Add(other.GetChecksum()); }
+
+	[[nodiscard]] WorldChecksum GetChecksum() const
+	{
+		// Final avalanche, so the last added values change all the bits
+		WorldChecksum checksum = _checksum;
+		checksum ^= checksum >> 33u;
+		checksum *= 0xFF51AFD7ED558CCDull;
+		checksum ^= checksum >> 33u;
+		return checksum;
+	}
+
+private:
+	WorldChecksum _checksum = 0x9E3779B97F4A7C15ull;
+};
+
+template <typename T>
+void WorldChecksumBuilder::Add(const T value)
+{
+	static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "Only scalar values can be added to a checksum");
+
+	std::uint64_t word = 0;
+	if constexpr (std::is_floating_point_v<T>)
+	{
+		// The bits are hashed, a desync of a single ulp is detected
+		word = std::bit_cast<std::conditional_t<sizeof(T) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>>(
+			value);
+	}
+	else
+	{
+		word = static_cast<std::uint64_t>(value);
+	}
+
+	_checksum = std::rotl((_checksum ^ word) * 0x87C37B91114253D5ull, 31) * 0x4CF5AD432745937Full;
+}
+}
@@ -14,10 +14,10 @@ struct sqlite3;
 namespace game
 {
 
-struct DbPhysicsState
+struct DbWorldChecksum
 {
-    std::array<PhysicsState, maxPlayerNmb> serverStates{};
-    std::array<PhysicsState, maxPlayerNmb> localStates{};
+    WorldChecksum serverChecksum{};
+    WorldChecksum localChecksum{};
     Frame lastLocalValidateFrame{};
     Frame validateFrame{};
 };
@@ -27,7 +27,7 @@ class DebugDatabase
 public:
     void Open(std::string_view path);
     void StorePacket(const PlayerInputPacket* inputPacket);
-    void StorePhysicsState(const DbPhysicsState& physicsState);
+    void StoreWorldChecksum(const DbWorldChecksum& worldChecksum);
     void Close();
 private:
     void Loop();
@@ -3,10 +3,12 @@
 
 #include <chrono>
 #include <memory>
+#include <vector>
 
 #include <SFML/Network/Packet.hpp>
 
 #include "game/game_globals.hpp"
+#include "game/world_checksum.hpp"
 
 namespace game
 {
@@ -22,14 +24,11 @@ enum class PacketType : std::uint8_t
 	LoseGame,
 	Ping,
 	SpawnFallingWall,
+	ResyncRequest,
+	ResyncWorld,
 	None,
 };
 
-/**
- * \brief PhysicsState is the type of the physics state checksum
- */
-using PhysicsState = std::uint16_t;
-
 /**
  * \brief Packet is a interface that defines what a packet with a PacketType.
  */
@@ -84,6 +83,28 @@ sf::Packet& operator>>(sf::Packet& packet, std::array<T, N>& t)
 	return packet;
 }
 
+inline sf::Packet& operator<<(sf::Packet& packet, const std::vector<std::uint8_t>& bytes)
+{
+	packet << static_cast<std::uint32_t>(bytes.size());
+	for (const auto byte : bytes)
+	{
+		packet << byte;
+	}
+	return packet;
+}
+
+inline sf::Packet& operator>>(sf::Packet& packet, std::vector<std::uint8_t>& bytes)
+{
+	std::uint32_t size = 0;
+	packet >> size;
+	bytes.resize(size);
+	for (auto& byte : bytes)
+	{
+		packet >> byte;
+	}
+	return packet;
+}
+
 /**
  * \brief JoinPacket is a TCP Packet that is sent by a client to the server to join a game.
  */
@@ -149,24 +170,37 @@ inline sf::Packet& operator>>(sf::Packet& packet, SpawnPlayerPacket& spawnPlayer
 /**
  * \brief PlayerInputPacket is a UDP Packet sent by the player client and then replicated by the server to all clients to share the currentFrame
  * and all the previous ones player inputs.
+ * The other clients use the input delay and the frame advantage of the sender to synchronize their clocks.
  */
 struct PlayerInputPacket final : TypedPacket<PacketType::Input>
 {
 	PlayerNumber playerNumber = INVALID_PLAYER;
 	std::array<std::uint8_t, sizeof(Frame)> currentFrame{};
 	std::array<std::uint8_t, MAX_INPUT_NMB> inputs{};
+
+	/**
+	 * \brief Number of frames between the frame the sender was playing and currentFrame.
+	 */
+	std::uint8_t inputDelay = 0;
+
+	/**
+	 * \brief Number of frames the sender is ahead of the other clients, negative when it is behind.
+	 */
+	std::int8_t frameAdvantage = 0;
 };
 
 inline sf::Packet& operator<<(sf::Packet& packet, const PlayerInputPacket& playerInputPacket)
 {
 	return packet << playerInputPacket.playerNumber <<
-		playerInputPacket.currentFrame << playerInputPacket.inputs;
+		playerInputPacket.currentFrame << playerInputPacket.inputs <<
+		playerInputPacket.inputDelay << playerInputPacket.frameAdvantage;
 }
 
 inline sf::Packet& operator>>(sf::Packet& packet, PlayerInputPacket& playerInputPacket)
 {
 	return packet >> playerInputPacket.playerNumber >>
-		playerInputPacket.currentFrame >> playerInputPacket.inputs;
+		playerInputPacket.currentFrame >> playerInputPacket.inputs >>
+		playerInputPacket.inputDelay >> playerInputPacket.frameAdvantage;
 }
 
 /**
@@ -177,22 +211,22 @@ struct StartGamePacket final : TypedPacket<PacketType::StartGame>
 };
 
 /**
- * \brief ValidateFramePacket is an UDP packet that is sent by the server to validate the last physics state of the world.
+ * \brief ValidateFramePacket is an UDP packet that is sent by the server to validate a frame with the checksum of its world.
  */
 struct ValidateFramePacket final : TypedPacket<PacketType::ValidateState>
 {
 	std::array<std::uint8_t, sizeof(Frame)> newValidateFrame{};
-	std::array<std::uint8_t, sizeof(PhysicsState) * MAX_PLAYER_NMB> physicsState{};
+	std::array<std::uint8_t, sizeof(WorldChecksum)> worldChecksum{};
 };
 
 inline sf::Packet& operator<<(sf::Packet& packet, const ValidateFramePacket& validateFramePacket)
 {
-	return packet << validateFramePacket.newValidateFrame << validateFramePacket.physicsState;
+	return packet << validateFramePacket.newValidateFrame << validateFramePacket.worldChecksum;
 }
 
 inline sf::Packet& operator>>(sf::Packet& packet, ValidateFramePacket& validateFramePacket)
 {
-	return packet >> validateFramePacket.newValidateFrame >> validateFramePacket.physicsState;
+	return packet >> validateFramePacket.newValidateFrame >> validateFramePacket.worldChecksum;
 }
 
 /**
@@ -249,6 +283,50 @@ inline sf::Packet& operator>>(sf::Packet& packet, SpawnFallingWallPacket& pingPa
 	return packet >> pingPacket.spawnFrame >> pingPacket.doorPosition >> pingPacket.requiresBall;
 }
 
+/**
+ * \brief ResyncRequestPacket is a TCP Packet sent by a client to the server when its validated world checksum differs.
+ */
+struct ResyncRequestPacket final : TypedPacket<PacketType::ResyncRequest>
+{
+	PlayerNumber playerNumber = INVALID_PLAYER;
+	std::array<std::uint8_t, sizeof(Frame)> mismatchFrame{};
+};
+
+inline sf::Packet& operator<<(sf::Packet& packet, const ResyncRequestPacket& resyncRequestPacket)
+{
+	return packet << resyncRequestPacket.playerNumber << resyncRequestPacket.mismatchFrame;
+}
+
+inline sf::Packet& operator>>(sf::Packet& packet, ResyncRequestPacket& resyncRequestPacket)
+{
+	return packet >> resyncRequestPacket.playerNumber >> resyncRequestPacket.mismatchFrame;
+}
+
+/**
+ * \brief ResyncWorldPacket is a TCP Packet sent by the server to answer a ResyncRequestPacket.
+ * It contains the compressed serialized world of the last validated frame of the server.
+ */
+struct ResyncWorldPacket final : TypedPacket<PacketType::ResyncWorld>
+{
+	PlayerNumber playerNumber = INVALID_PLAYER;
+	std::array<std::uint8_t, sizeof(Frame)> validateFrame{};
+	std::array<std::uint8_t, sizeof(WorldChecksum)> worldChecksum{};
+	std::array<std::uint8_t, sizeof(std::uint32_t)> worldSize{};
+	std::vector<std::uint8_t> compressedWorld;
+};
+
+inline sf::Packet& operator<<(sf::Packet& packet, const ResyncWorldPacket& resyncWorldPacket)
+{
+	return packet << resyncWorldPacket.playerNumber << resyncWorldPacket.validateFrame <<
+		resyncWorldPacket.worldChecksum << resyncWorldPacket.worldSize << resyncWorldPacket.compressedWorld;
+}
+
+inline sf::Packet& operator>>(sf::Packet& packet, ResyncWorldPacket& resyncWorldPacket)
+{
+	return packet >> resyncWorldPacket.playerNumber >> resyncWorldPacket.validateFrame >>
+		resyncWorldPacket.worldChecksum >> resyncWorldPacket.worldSize >> resyncWorldPacket.compressedWorld;
+}
+
 inline void GeneratePacket(sf::Packet& packet, Packet& sendingPacket)
 {
 	packet << sendingPacket;
@@ -306,6 +384,18 @@ inline void GeneratePacket(sf::Packet& packet, Packet& sendingPacket)
 			packet << packetTmp;
 			break;
 		}
+	case PacketType::ResyncRequest:
+		{
+			const auto& packetTmp = static_cast<ResyncRequestPacket&>(sendingPacket);
+			packet << packetTmp;
+			break;
+		}
+	case PacketType::ResyncWorld:
+		{
+			const auto& packetTmp = static_cast<ResyncWorldPacket&>(sendingPacket);
+			packet << packetTmp;
+			break;
+		}
 	default:
 		break;
 	}
@@ -379,6 +469,20 @@ inline std::unique_ptr<Packet> GenerateReceivedPacket(sf::Packet& packet)
 			packet >> *spawnFallingWallPacket;
 			return spawnFallingWallPacket;
 		}
+	case PacketType::ResyncRequest:
+		{
+			auto resyncRequestPacket = std::make_unique<ResyncRequestPacket>();
+			resyncRequestPacket->packetType = packetTmp.packetType;
+			packet >> *resyncRequestPacket;
+			return resyncRequestPacket;
+		}
+	case PacketType::ResyncWorld:
+		{
+			auto resyncWorldPacket = std::make_unique<ResyncWorldPacket>();
+			resyncWorldPacket->packetType = packetTmp.packetType;
+			packet >> *resyncWorldPacket;
+			return resyncWorldPacket;
+		}
 	default:
 		break;
 	}
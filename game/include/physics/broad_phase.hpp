@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "engine/entity.hpp"
+
+namespace game
+{
+enum class BroadPhaseType : std::uint8_t
+{
+	Grid,
+	SweepAndPrune,
+};
+
+/**
+* \brief Generic class for the broad phases, which find the pairs of bodies that may collide.
+*/
+class BroadPhase
+{
+public:
+	BroadPhase() = default;
+	virtual ~BroadPhase() = default;
+	BroadPhase(const BroadPhase& other) = default;
+	BroadPhase(BroadPhase&& other) = default;
+	BroadPhase& operator=(const BroadPhase& other) = delete;
+	BroadPhase& operator=(BroadPhase&& other) = delete;
+
+	/**
+	 * \brief Updates the broad phase with the current bodies.
+	 */
+	virtual void Update() = 0;
+
+	/**
+	 * \brief Find all the pair of objects that may collide.
+	 * Does not contain any duplicates, the pairs are sorted by their lower then their higher Entity,
+	 * so every broad phase gives its pairs in the same order.
+	 * \param collisionPairs Buffer cleared then filled with the pair of objects that may collide.
+	 */
+	virtual void GetCollisionPairs(std::vector<std::pair<core::Entity, core::Entity>>& collisionPairs) = 0;
+
+protected:
+	/**
+	 * \brief Packs a pair in a key, the lower Entity in the high bits, so sorting the keys sorts the pairs.
+	 */
+	static std::uint64_t PackPair(const core::Entity lowerEntity, const core::Entity higherEntity)
+	{
+		return static_cast<std::uint64_t>(lowerEntity) << 32u | higherEntity;
+	}
+
+	/**
+	 * \brief Unpacks sorted keys in the pairs, skipping the pairs with a destroyed Entity.
+	 * \param pairKeys Sorted keys without duplicates.
+	 * \param entityManager Manager of the Entities.
+	 * \param collisionPairs Buffer cleared then filled with the pairs.
+	 */
+	static void UnpackPairs(std::span<const std::uint64_t> pairKeys, const core::EntityManager& entityManager,
+	                        std::vector<std::pair<core::Entity, core::Entity>>& collisionPairs);
+};
+}
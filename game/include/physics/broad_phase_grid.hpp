@@ -1,8 +1,9 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
 #include <vector>
 
+#include "broad_phase.hpp"
 #include "rigidbody.hpp"
 
 #include "engine/entity.hpp"
@@ -17,8 +18,10 @@ namespace game
 * that are in the same cell.
 *
 * A collider that spans on multiple cells will have a pointer on every cell.
+* The cells are flattened in one array of entities, sorted by cell with a counting sort,
+* and a bitset marks the occupied cells.
 */
-class BroadPhaseGrid
+class BroadPhaseGrid final : public BroadPhase
 {
 public:
 	/**
@@ -41,30 +44,55 @@ public:
 	/**
 	 * \brief Updates the layout of the grid.
 	 */
-	void Update();
+	void Update() override;
 
 	/**
 	 * \brief Find all the pair of objects that are in the same cell.
-	 * Does not contain any duplicates.
-	 * \return The pair of objects that will collide.
+	 * \see BroadPhase::GetCollisionPairs
 	 */
-	[[nodiscard]] std::vector<std::pair<core::Entity, core::Entity>> GetCollisionPairs() const;
+	void GetCollisionPairs(std::vector<std::pair<core::Entity, core::Entity>>& collisionPairs) override;
 
 private:
-	std::vector<std::vector<std::vector<core::Entity>>> _grid;
+	/**
+	 * \brief Range of cells covered by a body, kept between the two passes of Update.
+	 */
+	struct BodyCells
+	{
+		core::Entity entity;
+		int xMin;
+		int yMin;
+		int xMax;
+		int yMax;
+	};
+
 	core::Vec2f _min;
 	core::Vec2f _max;
 	float _cellSize;
 	std::size_t _gridWidth;
 	std::size_t _gridHeight;
+	std::size_t _cellCount;
+
+	/**
+	 * \brief Index of the first entity of each cell in _cellEntities, with one more element for the end of the last cell.
+	 */
+	std::vector<std::uint32_t> _cellStarts;
+	std::vector<std::uint32_t> _cellCursors;
+	std::vector<core::Entity> _cellEntities;
+	/**
+	 * \brief One bit per cell, set if the cell holds at least one entity.
+	 */
+	std::vector<std::uint64_t> _occupiedCells;
+	std::vector<BodyCells> _bodies;
+	std::vector<std::uint64_t> _pairKeys;
 
 	core::EntityManager& _entityManager;
 	RigidbodyManager& _rigidbodyManager;
 	AabbColliderManager& _aabbManager;
 	CircleColliderManager& _circleManager;
 
-	static bool HasBeenChecked(
-		const std::unordered_multimap<core::Entity, core::Entity>& checkedCollisions,
-		const std::pair<core::Entity, core::Entity>& bodyPair);
+	[[nodiscard]] std::size_t GetCellIndex(const int x, const int y) const
+	{
+		return static_cast<std::size_t>(x) * _gridHeight + static_cast<std::size_t>(y);
+	}
 };
 }
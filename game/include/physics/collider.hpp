@@ -1,4 +1,5 @@
 #pragma once
+#include <type_traits>
 
 #include "manifold.hpp"
 
@@ -11,39 +12,30 @@
 
 namespace game
 {
-struct CircleCollider;
-struct AabbCollider;
-
 /**
- * \brief A pure virtual struct that represents colliders.
+ * \brief The data shared by all the colliders.
+ * Colliders have no virtual methods, so they stay trivially copyable and their arrays are copied with memcpy
+ * when the game world is saved and restored. ColliderPtr dispatches on the type of the collider instead.
  */
 struct Collider
 {
-public:
-	Collider() = default;
-	Collider(Collider&& col) noexcept = default;
-	virtual ~Collider() = default;
-	Collider& operator=(Collider&& col) = default;
-	Collider& operator=(const Collider& col) = default;
-	Collider(const Collider& col) = default;
-
 	/**
 	* \brief The center of the collider.
 	*/
 	core::Vec2f center{};
+};
 
+struct AabbCollider;
+
+/**
+ * \brief A circle collider.
+ */
+struct CircleCollider final : Collider
+{
 	/**
-	 * \brief Tests the collision against a generic collider.
-	 * \param transform The transform of this collider.
-	 * \param collider The collider to collide with.
-	 * \param colliderTransform The transform of the collider to collide with.
-	 * \return The manifold of that collision.
+	 * \brief Radius of the circle.
 	 */
-	virtual Manifold TestCollision(
-		const Transform* transform,
-		const Collider* collider,
-		const Transform* colliderTransform
-	) const = 0;
+	float radius = 0;
 
 	/**
 	 * \brief Tests the collision against a circle collider.
@@ -52,11 +44,11 @@ public:
 	 * \param circleTransform The transform of the collider to collide with.
 	 * \return The manifold of that collision.
 	 */
-	virtual Manifold TestCollision(
+	Manifold TestCollision(
 		const Transform* transform,
 		const CircleCollider* collider,
 		const Transform* circleTransform
-	) const = 0;
+	) const;
 
 	/**
 	 * \brief Tests the collision against a aabb collider.
@@ -65,11 +57,8 @@ public:
 	 * \param aabbTransform The transform of the collider to collide with.
 	 * \return The manifold of that collision.
 	 */
-	virtual Manifold TestCollision(
-		const Transform* transform,
-		const AabbCollider* collider,
-		const Transform* aabbTransform
-	) const = 0;
+	Manifold TestCollision(const Transform* transform, const AabbCollider* collider,
+	                       const Transform* aabbTransform) const;
 
 	/**
 	 * \brief Find the furthest point in the specified direction.
@@ -77,49 +66,16 @@ public:
 	 * \param direction Direction in which to find the furthest point.
 	 * \return The furthest point.
 	 */
-	[[nodiscard]] virtual core::Vec2f FindFurthestPoint(
+	[[nodiscard]] core::Vec2f FindFurthestPoint(
 		const Transform* transform,
 		const core::Vec2f& direction
-	) const = 0;
+	) const;
 
 	/**
 	 * \brief Gets the size of the box that surrounds the collider.
 	 * \return The bounding box of the collider.
 	 */
-	[[nodiscard]] virtual core::Vec2f GetBoundingBoxSize() const = 0;
-};
-
-/**
- * \brief A circle collider.
- */
-struct CircleCollider final : Collider
-{
-public:
-	/**
-	 * \brief Radius of the circle.
-	 */
-	float radius = 0;
-
-	Manifold TestCollision(
-		const Transform* transform,
-		const Collider* collider,
-		const Transform* colliderTransform
-	) const override;
-
-	Manifold TestCollision(
-		const Transform* transform,
-		const CircleCollider* collider,
-		const Transform* circleTransform
-	) const override;
-
-	Manifold TestCollision(const Transform* transform, const AabbCollider* collider,
-	                       const Transform* aabbTransform) const override;
-
-	[[nodiscard]] core::Vec2f FindFurthestPoint(
-		const Transform* transform,
-		const core::Vec2f& direction
-	) const override;
-	[[nodiscard]] core::Vec2f GetBoundingBoxSize() const override;
+	[[nodiscard]] core::Vec2f GetBoundingBoxSize() const;
 };
 
 /**
@@ -136,15 +92,69 @@ struct AabbCollider final : Collider
 	 */
 	float halfHeight = 0;
 
-	Manifold TestCollision(const Transform* transform, const Collider* collider,
-	                       const Transform* colliderTransform) const override;
 	Manifold TestCollision(const Transform* transform, const CircleCollider* collider,
-	                       const Transform* circleTransform) const override;
+	                       const Transform* circleTransform) const;
 	Manifold TestCollision(const Transform* transform, const AabbCollider* collider,
-	                       const Transform* aabbTransform) const override;
+	                       const Transform* aabbTransform) const;
 	[[nodiscard]] core::Vec2f
-	FindFurthestPoint(const Transform* transform, const core::Vec2f& direction) const override;
-	[[nodiscard]] core::Vec2f GetBoundingBoxSize() const override;
+	FindFurthestPoint(const Transform* transform, const core::Vec2f& direction) const;
+	[[nodiscard]] core::Vec2f GetBoundingBoxSize() const;
+};
+
+static_assert(std::is_trivially_copyable_v<CircleCollider>, "Colliders are copied with memcpy");
+static_assert(std::is_trivially_copyable_v<AabbCollider>, "Colliders are copied with memcpy");
+
+/**
+ * \brief A pointer to the collider of an entity, tagged with the type of the collider.
+ * A null ColliderPtr means that the entity has no collider.
+ */
+class ColliderPtr
+{
+public:
+	ColliderPtr() = default;
+
+	ColliderPtr(const CircleCollider* circleCollider)
+		: _type(core::ComponentType::CircleCollider), _collider(circleCollider)
+	{
+	}
+
+	ColliderPtr(const AabbCollider* aabbCollider)
+		: _type(core::ComponentType::AabbCollider), _collider(aabbCollider)
+	{
+	}
+
+	explicit operator bool() const { return _collider != nullptr; }
+	const Collider* operator->() const { return _collider; }
+
+	[[nodiscard]] core::ComponentType GetType() const { return _type; }
+
+	/**
+	 * \brief Tests the collision against the collider of another entity.
+	 * \param transform The transform of this collider.
+	 * \param collider The collider to collide with.
+	 * \param colliderTransform The transform of the collider to collide with.
+	 * \return The manifold of that collision.
+	 */
+	[[nodiscard]] Manifold TestCollision(
+		const Transform* transform,
+		ColliderPtr collider,
+		const Transform* colliderTransform
+	) const;
+
+	/**
+	 * \brief Gets the size of the box that surrounds the collider.
+	 * \return The bounding box of the collider.
+	 */
+	[[nodiscard]] core::Vec2f GetBoundingBoxSize() const;
+
+private:
+	[[nodiscard]] Manifold TestCollision(const Transform* transform, const CircleCollider* collider,
+	                                     const Transform* circleTransform) const;
+	[[nodiscard]] Manifold TestCollision(const Transform* transform, const AabbCollider* collider,
+	                                     const Transform* aabbTransform) const;
+
+	core::ComponentType _type = core::ComponentType::Empty;
+	const Collider* _collider = nullptr;
 };
 
 class AabbColliderManager final :
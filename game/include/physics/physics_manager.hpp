@@ -3,10 +3,12 @@
 
 #include <SFML/System/Time.hpp>
 
+#include "broad_phase.hpp"
 #include "broad_phase_grid.hpp"
 #include "collision.hpp"
 #include "rigidbody.hpp"
 #include "solver.hpp"
+#include "sweep_and_prune.hpp"
 #include "event_interfaces.hpp"
 #include "layers.hpp"
 
@@ -35,19 +37,22 @@ public:
 
 	static std::optional<core::ComponentType>
 	HasCollider(const core::EntityManager& entityManager, core::Entity entity);
-	[[nodiscard]] static Collider* GetCollider(
+	[[nodiscard]] static ColliderPtr GetCollider(
 		const core::EntityManager& entityManager,
-		AabbColliderManager& aabbManager,
-		CircleColliderManager& circleManager,
+		const AabbColliderManager& aabbManager,
+		const CircleColliderManager& circleManager,
 		core::Entity entity);
 
-	[[nodiscard]] Collider* GetCollider(core::Entity entity);
+	[[nodiscard]] ColliderPtr GetCollider(core::Entity entity) const;
 
-	[[nodiscard]] const Rigidbody& GetRigidbody(core::Entity entity) const;
-	[[nodiscard]] Rigidbody& GetRigidbody(core::Entity entity);
+	[[nodiscard]] Rigidbody GetRigidbody(core::Entity entity) const;
 	void SetRigidbody(core::Entity entity, Rigidbody& body);
 	void AddRigidbody(core::Entity entity);
 
+	[[nodiscard]] Transform& GetTransform(core::Entity entity);
+	[[nodiscard]] const core::Vec2f& GetVelocity(core::Entity entity) const;
+	void ApplyForce(core::Entity entity, const core::Vec2f& addedForce);
+
 	void AddAabbCollider(core::Entity entity);
 	void SetAabbCollider(core::Entity entity, const AabbCollider& aabbCollider);
 	[[nodiscard]] AabbCollider& GetAabbCollider(core::Entity entity);
@@ -69,13 +74,78 @@ public:
 	void RegisterTriggerListener(OnTriggerInterface& onTriggerInterface);
 	void RegisterCollisionListener(OnCollisionInterface& onCollisionInterface);
 
-	void CopyAllComponents(const PhysicsManager& physicsManager);
+	[[nodiscard]] RigidbodyManager& GetRigidbodyManager() { return _rigidbodyManager; }
+	[[nodiscard]] const RigidbodyManager& GetRigidbodyManager() const { return _rigidbodyManager; }
+
+	[[nodiscard]] const std::vector<AabbCollider>& GetAllAabbColliders() const
+	{
+		return _aabbManager.GetAllComponents();
+	}
+
+	[[nodiscard]] const std::vector<CircleCollider>& GetAllCircleColliders() const
+	{
+		return _circleManager.GetAllComponents();
+	}
+
+	/**
+	 * \brief The ResizeAll methods give access to the internal component arrays to be overwritten.
+	 * They are used by the RollbackManager when restoring a serialized world.
+	 */
+	[[nodiscard]] std::span<AabbCollider> ResizeAllAabbColliders(const std::size_t size)
+	{
+		return _aabbManager.ResizeAllComponents(size);
+	}
+
+	[[nodiscard]] std::span<CircleCollider> ResizeAllCircleColliders(const std::size_t size)
+	{
+		return _circleManager.ResizeAllComponents(size);
+	}
+
+	/**
+	 * \brief SetDirtyTracking is a method that tracks the rigidbodies and colliders that may be modified,
+	 * see core::ComponentManager::SetDirtyTracking.
+	 */
+	void SetDirtyTracking(bool isTracking);
+	void ClearDirty();
+
+	/**
+	 * \brief The RestoreDirty methods overwrite only the components modified since the dirty flags were cleared.
+	 * They are used by the RollbackManager when restoring a serialized world incrementally.
+	 */
+	template <typename Function>
+	void RestoreDirtyAabbColliders(Function getSavedAabbCollider)
+	{
+		_aabbManager.RestoreDirtyComponents(getSavedAabbCollider);
+	}
+
+	template <typename Function>
+	void RestoreDirtyCircleColliders(Function getSavedCircleCollider)
+	{
+		_circleManager.RestoreDirtyComponents(getSavedCircleCollider);
+	}
+
 	void Draw(sf::RenderTarget& renderTarget) override;
 
 	void ApplyGravity();
 	void ResolveCollisions(sf::Time deltaTime);
 	void SolveCollisions(const std::vector<Collision>& collisions, sf::Time deltaTime);
 
+	/**
+	 * \brief SetSolverIterations is a method that sets the number of times the impulses of the contacts are solved
+	 * each frame, the position correction is applied once. It must be the same on every peer.
+	 * \param solverIterations is the number of impulse passes over the contacts, at least one
+	 */
+	void SetSolverIterations(std::size_t solverIterations);
+	[[nodiscard]] std::size_t GetSolverIterations() const { return _solverIterations; }
+
+	/**
+	 * \brief SetBroadPhaseType is a method that chooses the broad phase finding the pairs of bodies that may collide.
+	 * Every broad phase gives its pairs in the same order, but it must be the same on every peer.
+	 * \param broadPhaseType is the broad phase used from the next FixedUpdate
+	 */
+	void SetBroadPhaseType(BroadPhaseType broadPhaseType);
+	[[nodiscard]] BroadPhaseType GetBroadPhaseType() const { return _broadPhaseType; }
+
 private:
 	static void SendCollisionCallbacks(const std::vector<Collision>& collisions,
 	                                   core::Action<core::Entity, core::Entity>& action);
@@ -92,6 +162,17 @@ private:
 	ImpulseSolver _impulseSolver;
 	SmoothPositionSolver _smoothPositionSolver;
 	BroadPhaseGrid _grid;
+	SweepAndPrune _sweepAndPrune;
+	BroadPhaseType _broadPhaseType = BroadPhaseType::SweepAndPrune;
+	BroadPhase* _broadPhase = &_sweepAndPrune;
+
+	/**
+	 * \brief Pairs of the broad phase and contacts of the narrow phase of the frame, kept to reuse their allocation.
+	 */
+	std::vector<std::pair<core::Entity, core::Entity>> _collisionPairs;
+	std::vector<Collision> _collisions;
+	std::vector<Collision> _triggers;
+	std::size_t _solverIterations;
 
 	core::Vec2f _gravity = {0, -9.81f};
 
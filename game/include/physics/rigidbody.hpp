@@ -15,12 +15,42 @@ enum class BodyType : std::uint8_t
 	Dynamic,
 };
 
+/**
+ * \brief RigidbodyProperties is the configuration of a Rigidbody, which is rarely modified after its creation.
+ * It is stored apart from the kinematic state of the body, so the integration does not load it for every body.
+ */
+struct RigidbodyProperties
+{
+	core::Vec2f gravityAcceleration{};
+
+	float invMass = 1.0f;
+	bool takesGravity = true;
+
+	float staticFriction{};
+	float dynamicFriction{};
+	float restitution{};
+	float dragFactor = 1.0f;
+
+	bool isTrigger = false;
+
+	BodyType bodyType = BodyType::Static;
+	Layer layer = Layer::None;
+
+	[[nodiscard]] bool IsDynamic() const { return bodyType == BodyType::Dynamic; }
+	[[nodiscard]] bool IsStatic() const { return bodyType == BodyType::Static; }
+	[[nodiscard]] bool IsKinematic() const { return bodyType == BodyType::Kinematic; }
+	[[nodiscard]] bool HasCollisions() const { return IsDynamic() || IsKinematic(); }
+};
+
 /**
 * \brief A Rigidbody that has dynamics.
+* It is a copy of a body of the RigidbodyManager, which stores its state and its properties in separate arrays.
 */
 struct Rigidbody
 {
-	Rigidbody();
+	Rigidbody() = default;
+	Rigidbody(const Transform& transform, const core::Vec2f& velocity, const core::Vec2f& force,
+	          const RigidbodyProperties& properties);
 
 	/**
 	 * \brief Gets the transform of the body.
@@ -165,47 +195,99 @@ struct Rigidbody
 	 */
 	void SetRestitution(float restitution);
 
-	[[nodiscard]] float DragFactor() const { return _dragFactor; }
-	void SetDragFactor(const float dragFactor) { _dragFactor = dragFactor; }
-
-	[[nodiscard]] Layer GetLayer() const { return _layer; }
-	void SetLayer(const Layer layer) { _layer = layer; }
+	[[nodiscard]] float DragFactor() const { return _properties.dragFactor; }
+	void SetDragFactor(const float dragFactor) { _properties.dragFactor = dragFactor; }
 
-	[[nodiscard]] bool IsDynamic() const { return _bodyType == BodyType::Dynamic; }
-	[[nodiscard]] bool IsStatic() const { return _bodyType == BodyType::Static; }
-	[[nodiscard]] bool IsKinematic() const { return _bodyType == BodyType::Kinematic; }
-	[[nodiscard]] bool HasCollisions() const { return IsDynamic() || IsKinematic(); }
-	[[nodiscard]] BodyType GetBodyType() const { return _bodyType; }
-	void SetBodyType(const BodyType bodyType) { _bodyType = bodyType; }
-
-private:
-	core::Vec2f _gravityAcceleration;
-	core::Vec2f _force;
-	core::Vec2f _velocity;
+	[[nodiscard]] Layer GetLayer() const { return _properties.layer; }
+	void SetLayer(const Layer layer) { _properties.layer = layer; }
 
-	float _invMass{};
-	bool _takesGravity = false;
+	[[nodiscard]] bool IsDynamic() const { return _properties.IsDynamic(); }
+	[[nodiscard]] bool IsStatic() const { return _properties.IsStatic(); }
+	[[nodiscard]] bool IsKinematic() const { return _properties.IsKinematic(); }
+	[[nodiscard]] bool HasCollisions() const { return _properties.HasCollisions(); }
+	[[nodiscard]] BodyType GetBodyType() const { return _properties.bodyType; }
+	void SetBodyType(const BodyType bodyType) { _properties.bodyType = bodyType; }
 
-	float _staticFriction{};
-	float _dynamicFriction{};
-	float _restitution{};
-	float _dragFactor = 1.0f;
+	[[nodiscard]] const RigidbodyProperties& Properties() const { return _properties; }
 
+private:
 	Transform _transform{};
+	core::Vec2f _velocity;
+	core::Vec2f _force;
 
-	bool _isTrigger = false;
-
-	BodyType _bodyType = BodyType::Static;
-	Layer _layer = Layer::None;
+	RigidbodyProperties _properties;
 };
 
 /**
- * \brief BodyManager is a ComponentManager that holds all the Body in the world.
+ * \brief RigidbodyManager is a class that holds all the Rigidbody in the world.
+ * The bodies are split in structure of arrays: the transforms, velocities and forces read and written every frame
+ * each have their own array, and the properties of the bodies are in another one.
+ * The arrays are ComponentManager sharing the Rigidbody flag, so they are serialized and restored as any component.
  */
-class RigidbodyManager final :
-	public core::ComponentManager<Rigidbody, static_cast<core::EntityMask>(core::ComponentType::Rigidbody)>
+class RigidbodyManager
 {
 public:
-	using ComponentManager::ComponentManager;
+	static constexpr core::Component COMPONENT_FLAG = static_cast<core::EntityMask>(core::ComponentType::Rigidbody);
+
+	template <typename T>
+	using RigidbodyArray = core::ComponentManager<T, COMPONENT_FLAG>;
+
+	explicit RigidbodyManager(core::EntityManager& entityManager);
+
+	void AddComponent(core::Entity entity);
+	void RemoveComponent(core::Entity entity);
+
+	/**
+	 * \brief GetComponent is a method that gathers the arrays of an Entity in a copy of its Rigidbody.
+	 */
+	[[nodiscard]] Rigidbody GetComponent(core::Entity entity) const;
+	/**
+	 * \brief SetComponent is a method that scatters a Rigidbody in the arrays of an Entity.
+	 */
+	void SetComponent(core::Entity entity, const Rigidbody& body);
+
+	[[nodiscard]] Transform& GetTransform(const core::Entity entity) { return _transforms.GetComponent(entity); }
+	[[nodiscard]] const Transform& GetTransform(const core::Entity entity) const
+	{
+		return _transforms.GetComponent(entity);
+	}
+
+	[[nodiscard]] core::Vec2f& GetVelocity(const core::Entity entity) { return _velocities.GetComponent(entity); }
+	[[nodiscard]] const core::Vec2f& GetVelocity(const core::Entity entity) const
+	{
+		return _velocities.GetComponent(entity);
+	}
+
+	[[nodiscard]] core::Vec2f& GetForce(const core::Entity entity) { return _forces.GetComponent(entity); }
+	[[nodiscard]] const core::Vec2f& GetForce(const core::Entity entity) const
+	{
+		return _forces.GetComponent(entity);
+	}
+
+	[[nodiscard]] const RigidbodyProperties& GetProperties(const core::Entity entity) const
+	{
+		return _properties.GetComponent(entity);
+	}
+
+	/**
+	 * \brief The Array methods give access to the arrays of the bodies, to serialize and restore them.
+	 */
+	[[nodiscard]] RigidbodyArray<Transform>& GetTransformArray() { return _transforms; }
+	[[nodiscard]] const RigidbodyArray<Transform>& GetTransformArray() const { return _transforms; }
+	[[nodiscard]] RigidbodyArray<core::Vec2f>& GetVelocityArray() { return _velocities; }
+	[[nodiscard]] const RigidbodyArray<core::Vec2f>& GetVelocityArray() const { return _velocities; }
+	[[nodiscard]] RigidbodyArray<core::Vec2f>& GetForceArray() { return _forces; }
+	[[nodiscard]] const RigidbodyArray<core::Vec2f>& GetForceArray() const { return _forces; }
+	[[nodiscard]] RigidbodyArray<RigidbodyProperties>& GetPropertiesArray() { return _properties; }
+	[[nodiscard]] const RigidbodyArray<RigidbodyProperties>& GetPropertiesArray() const { return _properties; }
+
+	void SetDirtyTracking(bool isTracking);
+	void ClearDirty();
+
+private:
+	RigidbodyArray<Transform> _transforms;
+	RigidbodyArray<core::Vec2f> _velocities;
+	RigidbodyArray<core::Vec2f> _forces;
+	RigidbodyArray<RigidbodyProperties> _properties;
 };
 }
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "broad_phase.hpp"
+#include "rigidbody.hpp"
+
+#include "engine/entity.hpp"
+
+namespace game
+{
+/**
+* \brief A sweep and prune broad phase on the x axis.
+* The bounding boxes of the bodies are kept sorted by their lower x bound from one frame to the next.
+* As the bodies move little between two frames, the list is almost sorted and an insertion sort updates it in linear time.
+* The list is then swept, a body is only tested against the following ones until they start after its upper x bound.
+*/
+class SweepAndPrune final : public BroadPhase
+{
+public:
+	/**
+	 * \brief Constructs a new sweep and prune.
+	 * \param entityManager Manager of the Entities.
+	 * \param rigidbodyManager Manager of the Rigidbodies.
+	 * \param aabbManager Manager for Aabb colliders.
+	 * \param circleManager Manager for circle colliders.
+	 */
+	SweepAndPrune(core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager,
+	              AabbColliderManager& aabbManager, CircleColliderManager& circleManager);
+
+	/**
+	 * \brief Removes the bodies that lost their collider, updates the bounding boxes, adds the new bodies
+	 * and sorts the list again.
+	 */
+	void Update() override;
+
+	/**
+	 * \brief Find all the pair of objects whose bounding boxes overlap.
+	 * \see BroadPhase::GetCollisionPairs
+	 */
+	void GetCollisionPairs(std::vector<std::pair<core::Entity, core::Entity>>& collisionPairs) override;
+
+private:
+	/**
+	 * \brief Bounding box of a body in the sorted list.
+	 */
+	struct BodyBounds
+	{
+		core::Entity entity;
+		core::Vec2f min;
+		core::Vec2f max;
+	};
+
+	core::EntityManager& _entityManager;
+	RigidbodyManager& _rigidbodyManager;
+	AabbColliderManager& _aabbManager;
+	CircleColliderManager& _circleManager;
+
+	std::vector<BodyBounds> _bodies;
+	/**
+	 * \brief One flag per Entity, set if the Entity is in the sorted list.
+	 */
+	std::vector<bool> _isInList;
+	std::vector<std::uint64_t> _pairKeys;
+
+	/**
+	 * \brief Computes the bounding box of the body of an Entity.
+	 * \return false if the Entity has no rigidbody or no collider.
+	 */
+	bool ComputeBounds(core::Entity entity, BodyBounds& bounds) const;
+};
+}
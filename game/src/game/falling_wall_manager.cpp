@@ -4,35 +4,30 @@
 
 
 game::FallingObjectManager::FallingObjectManager(core::EntityManager& entityManager, PhysicsManager& physicsManager)
-	: ComponentManager(entityManager), _physicsManager(physicsManager)
+	: SparseComponentManager(entityManager), _physicsManager(physicsManager)
 {}
 
 void game::FallingObjectManager::SetFallingSpeed(const core::Entity entity, const float fallingSpeed)
 {
-	_components[entity].fallingSpeed = fallingSpeed;
+	GetComponent(entity).fallingSpeed = fallingSpeed;
 }
 
 void game::FallingObjectManager::FixedUpdate(const sf::Time deltaTime)
 {
-	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
+	ForEach([this, deltaTime](const core::Entity entity, const FallingObject& fallingObject)
 	{
 		const bool hasRigidbody = _entityManager.HasComponent(entity,
 			static_cast<core::EntityMask>(
 			core::ComponentType::Rigidbody));
-		const bool isFallingObject = _entityManager.HasComponent(entity,
-			static_cast<core::EntityMask>(
-			ComponentType::FallingObject));
 		const bool isDestroyed = _entityManager.HasComponent(entity,
 			static_cast<core::EntityMask>(ComponentType::Destroyed));
 
-		if (!hasRigidbody || !isFallingObject || isDestroyed) continue;
+		if (!hasRigidbody || isDestroyed) return;
 
-		const FallingObject& fallingObject = GetComponent(entity);
-		Rigidbody& rigidbody = _physicsManager.GetRigidbody(entity);
-		Transform& transform = rigidbody.Trans();
+		Transform& transform = _physicsManager.GetTransform(entity);
 		const float deltaFall = fallingObject.fallingSpeed * deltaTime.asSeconds();
 		transform.position = { transform.position.x, transform.position.y - deltaFall };
-	}
+	});
 }
 
 game::FallingDoorManager::FallingDoorManager(core::EntityManager& entityManager,
@@ -93,8 +88,8 @@ void game::FallingWallSpawnManager::FixedUpdate()
 	if (_nextFallingWallSpawnInstructions.spawnFrame == 0u) return;
 	if (_hasSpawned) return;
 
-	// If the frame we are at is bigger than the spawn frame, the wall is spawned
-	if (_nextFallingWallSpawnInstructions.spawnFrame <= _rollbackManager.GetLastValidateFrame())
+	// If the simulated frame is bigger than the spawn frame, the wall is spawned
+	if (_nextFallingWallSpawnInstructions.spawnFrame <= _rollbackManager.GetTestedFrame())
 	{
 		SpawnWall();
 	}
@@ -106,6 +101,13 @@ void game::FallingWallSpawnManager::CopyAllComponents(const FallingWallSpawnMana
 	_hasSpawned = fallingWallSpawnManager._hasSpawned;
 }
 
+void game::FallingWallSpawnManager::CopyAllComponents(
+	const FallingWallSpawnInstructions nextFallingWallSpawnInstructions, const bool hasSpawned)
+{
+	_nextFallingWallSpawnInstructions = nextFallingWallSpawnInstructions;
+	_hasSpawned = hasSpawned;
+}
+
 void game::FallingWallSpawnManager::SpawnWall()
 {
 	_hasSpawned = true;
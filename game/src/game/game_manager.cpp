@@ -1,9 +1,15 @@
 // ReSharper disable CppUseStructuredBinding
 #include "game/game_manager.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <limits>
+#include <thread>
 #include <imgui.h>
 
+#include "engine/view.hpp"
+
 #include "maths/basic.hpp"
 
 #include "utils/conversion.hpp"
@@ -16,9 +22,9 @@
 
 namespace game
 {
-GameManager::GameManager()
+GameManager::GameManager(const RollbackMode rollbackMode)
 	: _transformManager(_entityManager),
-	_rollbackManager(*this, _entityManager)
+	_rollbackManager(*this, _entityManager, rollbackMode)
 {
 	_playerEntityMap.fill(core::INVALID_ENTITY);
 }
@@ -134,16 +140,13 @@ bool GameManager::CheckIfLost() const
 {
 	int alivePlayer = 0;
 	const PlayerCharacterManager& playerManager = _rollbackManager.GetPlayerCharacterManager();
-	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
+	core::View(_entityManager, playerManager).ForEach([&alivePlayer](core::Entity, const PlayerCharacter& player)
 	{
-		if (!_entityManager.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::PlayerCharacter)))
-			continue;
-		const auto& player = playerManager.GetComponent(entity);
 		if (!player.isDead)
 		{
 			alivePlayer++;
 		}
-	}
+	});
 
 	return alivePlayer <= 1;
 }
@@ -154,7 +157,7 @@ void GameManager::LoseGame()
 }
 
 ClientGameManager::ClientGameManager(PacketSenderInterface& packetSenderInterface)
-	: GameManager(),
+	: GameManager(RollbackMode::Client),
 	_packetSenderInterface(packetSenderInterface),
 	_spriteManager(_entityManager, _transformManager),
 	_rectangleShapeManager(_entityManager, _transformManager)
@@ -179,21 +182,31 @@ void ClientGameManager::Update(const sf::Time dt)
 
 	if (_state & Started)
 	{
-		_rollbackManager.SimulateToCurrentFrame();
+		ConfirmPendingValidateFrames();
+	}
 
-		// Copy rollback transform position to our own
-		for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
-		{
-			// ReSharper disable once CppTooWideScope
-			const bool isPlayerWithSprite = _entityManager.HasComponent(entity,
-				static_cast<core::EntityMask>(ComponentType::PlayerCharacter) |
-				static_cast<core::EntityMask>(core::ComponentType::Sprite));
+	// A client ahead of the others plays slightly slower, so the others do not roll back every frame
+	_isTimeSyncStretching = _isTimeSyncEnabled && GetFrameAdvantage() >= TIME_SYNC_MIN_FRAME_ADVANTAGE;
+	const float fixedPeriod = _isTimeSyncStretching ? FIXED_PERIOD * (1.0f + TIME_SYNC_PERIOD_STRETCH) : FIXED_PERIOD;
 
-			if (isPlayerWithSprite)
-			{
-				// ReSharper disable once CppUseStructuredBinding
-				const auto& player = _rollbackManager.GetPlayerCharacterManager().GetComponent(entity);
+	_fixedTimer += dt.asSeconds();
+	while (_fixedTimer > fixedPeriod)
+	{
+		FixedUpdate();
+		_fixedTimer -= fixedPeriod;
+	}
+
+	if (_state & Started)
+	{
+		// The frames are sampled after the fixed updates, so they match the remainder of the fixed timer
+		_rollbackManager.SimulateToCurrentFrame();
+		SampleSimulatedTransforms();
 
+		const PlayerCharacterManager& playerManager = _rollbackManager.GetPlayerCharacterManager();
+		core::View(_entityManager, playerManager)
+			.With(static_cast<core::EntityMask>(core::ComponentType::Sprite))
+			.ForEach([this](const core::Entity entity, const PlayerCharacter& player)
+			{
 				if (player.hasBall && !player.hadBall)
 				{
 					_spriteManager.SetTexture(entity, _playerBallTexture);
@@ -202,22 +215,84 @@ void ClientGameManager::Update(const sf::Time dt)
 				{
 					_spriteManager.SetTexture(entity, _playerNoBallTexture);
 				}
-			}
+			});
 
-			if (_entityManager.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::Transform)))
-			{
-				_transformManager.SetPosition(entity, _rollbackManager.GetTransformManager().GetPosition(entity));
-				_transformManager.SetRotation(entity, _rollbackManager.GetTransformManager().GetRotation(entity));
-			}
+		// The remainder of the fixed timer places the rendered frame between the last two simulated ones
+		InterpolateTransforms(_isInterpolating ? std::min(_fixedTimer / fixedPeriod, 1.0f) : 1.0f);
+	}
+}
+
+void ClientGameManager::SampleSimulatedTransforms()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	// A new simulated frame becomes the current one, a rollback of the same frame only corrects it
+	if (_sampledFrame != _currentFrame)
+	{
+		std::swap(_previousPositions, _currentPositions);
+		std::swap(_previousRotations, _currentRotations);
+		_sampledFrame = _currentFrame;
+	}
+
+	const std::size_t entityCount = _entityManager.GetEntitiesSize();
+	_previousPositions.resize(entityCount);
+	_previousRotations.resize(entityCount);
+	_currentPositions.resize(entityCount);
+	_currentRotations.resize(entityCount);
+	_hasSimulatedTransform.resize(entityCount, false);
+
+	// The simulated transforms are copied whole, the entities without one are skipped when interpolating
+	const core::TransformManager& simulatedTransformManager = _rollbackManager.GetTransformManager();
+	const auto& simulatedPositions = simulatedTransformManager.GetAllPositions();
+	const auto& simulatedRotations = simulatedTransformManager.GetAllRotations();
+	std::copy_n(simulatedPositions.begin(), std::min(simulatedPositions.size(), entityCount), _currentPositions.begin());
+	std::copy_n(simulatedRotations.begin(), std::min(simulatedRotations.size(), entityCount), _currentRotations.begin());
+
+	_interpolatedEntities.clear();
+	for (core::Entity entity = 0; entity < entityCount; entity++)
+	{
+		if (!_entityManager.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::Transform)))
+		{
+			_hasSimulatedTransform[entity] = false;
+			continue;
+		}
+
+		_interpolatedEntities.push_back(entity);
+
+		// Entities that were not simulated on the previous frame appear directly at their position
+		if (!_hasSimulatedTransform[entity])
+		{
+			_previousPositions[entity] = _currentPositions[entity];
+			_previousRotations[entity] = _currentRotations[entity];
+			_hasSimulatedTransform[entity] = true;
 		}
 	}
+}
 
-	_fixedTimer += dt.asSeconds();
-	while (_fixedTimer > FIXED_PERIOD)
+void ClientGameManager::InterpolateTransforms(const float ratio)
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	const std::size_t interpolatedCount = _interpolatedEntities.size();
+	_interpolatedPositions.resize(interpolatedCount);
+	_interpolatedRotations.resize(interpolatedCount);
+	for (std::size_t i = 0; i < interpolatedCount; i++)
 	{
-		FixedUpdate();
-		_fixedTimer -= FIXED_PERIOD;
+		const core::Entity entity = _interpolatedEntities[i];
+		_interpolatedPositions[i] = core::Vec2f::Lerp(_previousPositions[entity], _currentPositions[entity], ratio);
+
+		// The rotation turns by the shortest way
+		const core::Degree previousRotation = _previousRotations[entity];
+		const float deltaRotation = std::remainder((_currentRotations[entity] - previousRotation).Value(), 360.0f);
+		_interpolatedRotations[i] = previousRotation + core::Degree(deltaRotation * ratio);
 	}
+
+	_transformManager.SetPositions(_interpolatedEntities, _interpolatedPositions);
+	_transformManager.SetRotations(_interpolatedEntities, _interpolatedRotations);
 }
 
 void ClientGameManager::End()
@@ -453,21 +528,36 @@ void ClientGameManager::FixedUpdate()
 		return;
 	}
 
-	const auto& inputs = _rollbackManager.GetInputs(playerNumber);
 	auto playerInputPacket = std::make_unique<PlayerInputPacket>();
 	playerInputPacket->playerNumber = playerNumber;
-	playerInputPacket->currentFrame = core::ConvertToBinary(_currentFrame);
+	playerInputPacket->currentFrame = core::ConvertToBinary(_localInputFrame);
+	playerInputPacket->inputDelay = static_cast<std::uint8_t>(_localInputFrame - _currentFrame);
+
+	// The advantage over the remote client the most behind is sent
+	float localFrameAdvantage = std::numeric_limits<float>::lowest();
+	for (PlayerNumber remotePlayer = 0; remotePlayer < MAX_PLAYER_NMB; remotePlayer++)
+	{
+		if (remotePlayer == playerNumber) continue;
+
+		localFrameAdvantage = std::max(localFrameAdvantage, _localFrameAdvantages[remotePlayer]);
+	}
+
+	playerInputPacket->frameAdvantage = static_cast<std::int8_t>(std::clamp(std::round(localFrameAdvantage),
+	                                                                        -128.0f, 127.0f));
 	for (size_t i = 0; i < playerInputPacket->inputs.size(); i++)
 	{
-		if (i > _currentFrame) break;
+		if (i > _localInputFrame) break;
 
-		playerInputPacket->inputs[i] = inputs[i];
+		playerInputPacket->inputs[i] = _rollbackManager.GetInputAtFrame(playerNumber,
+		                                                                _localInputFrame - static_cast<Frame>(i));
 	}
 	_packetSenderInterface.SendUnreliablePacket(std::move(playerInputPacket));
+	_isLocalInputFrameSent = true;
 
 
 	_currentFrame++;
 	_rollbackManager.StartNewFrame(_currentFrame);
+	ScheduleLocalInputFrame();
 }
 
 void ClientGameManager::SetPlayerInput(const PlayerNumber playerNumber, const PlayerInput playerInput,
@@ -478,6 +568,92 @@ void ClientGameManager::SetPlayerInput(const PlayerNumber playerNumber, const Pl
 	GameManager::SetPlayerInput(playerNumber, playerInput, inputFrame);
 }
 
+void ClientGameManager::SetLocalPlayerInput(const PlayerInput playerInput)
+{
+	if (_isLocalInputFrameSent) return;
+
+	SetPlayerInput(GetPlayerNumber(), playerInput, _localInputFrame);
+}
+
+void ClientGameManager::SetRoundTripTime(const float srtt)
+{
+	_srtt = srtt;
+	UpdateInputDelay();
+}
+
+void ClientGameManager::UpdateInputDelay()
+{
+	if (!_isInputDelayAdaptive || _srtt < 0.0f) return;
+
+	// The remote inputs are late by about a round trip, the delay hides the half of it spent sending the local inputs
+	const auto oneWayFrames = static_cast<Frame>(std::ceil(_srtt / 2.0f / (FIXED_PERIOD * 1000.0f)));
+	_inputDelay = std::clamp(oneWayFrames, _minInputDelay, _maxInputDelay);
+}
+
+void ClientGameManager::ScheduleLocalInputFrame()
+{
+	// A shrinking delay keeps the sent frame until the current frame catches up with it
+	const Frame lastInputFrame = _localInputFrame;
+	_localInputFrame = std::max(_currentFrame + _inputDelay, lastInputFrame);
+	if (_localInputFrame == lastInputFrame) return;
+
+	// A growing delay skips frames, they keep the last sent input
+	const PlayerNumber playerNumber = GetPlayerNumber();
+	const PlayerInput lastInput = _rollbackManager.GetInputAtFrame(playerNumber, lastInputFrame);
+	for (Frame frame = lastInputFrame + 1; frame <= _localInputFrame; frame++)
+	{
+		SetPlayerInput(playerNumber, lastInput, frame);
+	}
+
+	_isLocalInputFrameSent = false;
+}
+
+void ClientGameManager::UpdateFrameAdvantage(const PlayerNumber playerNumber, const Frame remoteFrame,
+                                             const std::int8_t remoteFrameAdvantage)
+{
+	// The inputs went through the server, they were sent about a round trip ago
+	const float latencyFrames = _srtt > 0.0f ? _srtt / (FIXED_PERIOD * 1000.0f) : 0.0f;
+	const float localFrameAdvantage = static_cast<float>(_currentFrame) -
+		(static_cast<float>(remoteFrame) + latencyFrames);
+
+	_localFrameAdvantages[playerNumber] = std::lerp(_localFrameAdvantages[playerNumber], localFrameAdvantage,
+	                                                TIME_SYNC_SMOOTHING);
+	_remoteFrameAdvantages[playerNumber] = std::lerp(_remoteFrameAdvantages[playerNumber],
+	                                                 static_cast<float>(remoteFrameAdvantage), TIME_SYNC_SMOOTHING);
+}
+
+float ClientGameManager::GetFrameAdvantage() const
+{
+	float frameAdvantage = 0.0f;
+	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+	{
+		if (playerNumber == GetPlayerNumber()) continue;
+
+		frameAdvantage = std::max(frameAdvantage,
+		                          (_localFrameAdvantages[playerNumber] - _remoteFrameAdvantages[playerNumber]) / 2.0f);
+	}
+
+	return frameAdvantage;
+}
+
+void ClientGameManager::ConfirmPendingValidateFrames()
+{
+	// The newest reached validation also validates the frames before it
+	bool hasReachedValidateFrame = false;
+	std::pair<Frame, WorldChecksum> reachedValidateFrame{};
+	while (!_pendingValidateFrames.empty() && _pendingValidateFrames.front().first <= _currentFrame)
+	{
+		reachedValidateFrame = _pendingValidateFrames.front();
+		hasReachedValidateFrame = true;
+		_pendingValidateFrames.pop_front();
+	}
+
+	if (hasReachedValidateFrame)
+	{
+		ConfirmValidateFrame(reachedValidateFrame.first, reachedValidateFrame.second);
+	}
+}
+
 void ClientGameManager::StartGame(unsigned long long int startingTime)
 {
 	core::LogInfo(fmt::format("Start game at starting time: {}", startingTime));
@@ -497,17 +673,103 @@ void ClientGameManager::DrawImGui()
 		ImGui::Text("Current Time: %llu", ms);
 	}
 
+	ImGui::Text("Prediction hits: %zu, misses: %zu (%.1f%%)",
+	            _rollbackManager.GetPredictionHitCount(),
+	            _rollbackManager.GetPredictionMissCount(),
+	            _rollbackManager.GetPredictionHitRatio() * 100.0f);
+	ImGui::Text("Resyncs: %u", _resyncCount);
+	ImGui::Text("Rollback depth: %u frames (max: %u)",
+	            _rollbackManager.GetRollbackDepth(),
+	            _rollbackManager.GetMaxRollbackDepth());
+
+	ImGui::Text("Frame advantage: %.2f%s", GetFrameAdvantage(), _isTimeSyncStretching ? " (slowing down)" : "");
+	ImGui::Checkbox("Time Sync", &_isTimeSyncEnabled);
+
+	ImGui::Text("Input delay: %u frames", _inputDelay);
+	if (ImGui::Checkbox("Adaptive Input Delay", &_isInputDelayAdaptive))
+	{
+		UpdateInputDelay();
+	}
+
+	if (_isInputDelayAdaptive)
+	{
+		int minInputDelay = static_cast<int>(_minInputDelay);
+		int maxInputDelay = static_cast<int>(_maxInputDelay);
+		const bool hasMinChanged = ImGui::SliderInt("Min Input Delay", &minInputDelay, 0, static_cast<int>(_maxInputDelay));
+		const bool hasMaxChanged = ImGui::SliderInt("Max Input Delay", &maxInputDelay, static_cast<int>(_minInputDelay),
+		                                            static_cast<int>(MAX_INPUT_NMB) - 1);
+		if (hasMinChanged || hasMaxChanged)
+		{
+			_minInputDelay = static_cast<Frame>(minInputDelay);
+			_maxInputDelay = static_cast<Frame>(maxInputDelay);
+			UpdateInputDelay();
+		}
+	}
+	else
+	{
+		int inputDelay = static_cast<int>(_inputDelay);
+		if (ImGui::SliderInt("Input Delay", &inputDelay, 0, static_cast<int>(MAX_INPUT_NMB) - 1))
+		{
+			_inputDelay = static_cast<Frame>(inputDelay);
+		}
+	}
+
+	// The speculative timelines use the cores left idle by the main thread
+	bool isSpeculating = _rollbackManager.GetSpeculationHypothesisCount() > 0;
+	if (ImGui::Checkbox("Speculative Resimulation", &isSpeculating))
+	{
+		const std::size_t idleCoreCount = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+		_rollbackManager.SetSpeculationHypothesisCount(isSpeculating ? idleCoreCount : 0);
+	}
+
+	ImGui::Text("Speculation hits: %zu", _rollbackManager.GetSpeculationHitCount());
+
+	bool isIncrementalRestore = _rollbackManager.IsIncrementalRestore();
+	if (ImGui::Checkbox("Incremental Restore", &isIncrementalRestore))
+	{
+		_rollbackManager.SetIncrementalRestore(isIncrementalRestore);
+	}
+
+	// Every model is scored on the same inputs, the active one is used for the simulation
+	const auto& inputPredictors = _rollbackManager.GetInputPredictors();
+	const std::size_t activeInputPredictor = _rollbackManager.GetActiveInputPredictor();
+	if (ImGui::BeginCombo("Input Prediction", inputPredictors[activeInputPredictor]->GetName().data()))
+	{
+		for (std::size_t index = 0; index < inputPredictors.size(); index++)
+		{
+			if (ImGui::Selectable(inputPredictors[index]->GetName().data(), index == activeInputPredictor))
+			{
+				_rollbackManager.SetActiveInputPredictor(index);
+			}
+		}
+		ImGui::EndCombo();
+	}
+
+	for (const auto& inputPredictor : inputPredictors)
+	{
+		ImGui::Text("%s: %.1f%% (%zu/%zu)", inputPredictor->GetName().data(), inputPredictor->GetHitRatio() * 100.0f,
+		            inputPredictor->GetHitCount(), inputPredictor->GetHitCount() + inputPredictor->GetMissCount());
+	}
+
 	ImGui::Checkbox("Draw Physics", &_drawPhysics);
+	ImGui::Checkbox("Interpolate Rendering", &_isInterpolating);
 }
 
-void ClientGameManager::ConfirmValidateFrame(Frame newValidateFrame,
-	const std::array<PhysicsState, MAX_PLAYER_NMB>& physicsStates)
+void ClientGameManager::ConfirmValidateFrame(Frame newValidateFrame, const WorldChecksum worldChecksum)
 {
 	if (newValidateFrame < _rollbackManager.GetLastValidateFrame())
 	{
 		core::LogWarning(fmt::format("New validate frame is too old"));
 		return;
 	}
+
+	// The other clients send their delayed inputs before this client reaches their frame
+	if (newValidateFrame > _currentFrame)
+	{
+		_pendingValidateFrames.emplace_back(newValidateFrame, worldChecksum);
+		return;
+	}
+
 	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
 	{
 		if (_rollbackManager.GetLastReceivedFrame(playerNumber) < newValidateFrame)
@@ -523,7 +785,69 @@ void ClientGameManager::ConfirmValidateFrame(Frame newValidateFrame,
 			return;
 		}
 	}
-	_rollbackManager.ConfirmFrame(newValidateFrame, physicsStates);
+	if (_rollbackManager.ConfirmFrame(newValidateFrame, worldChecksum) || _isWaitingForResync || _hasResyncFailed)
+	{
+		return;
+	}
+
+	// The world of the server replaces the desynced validated world
+	auto resyncRequestPacket = std::make_unique<ResyncRequestPacket>();
+	resyncRequestPacket->playerNumber = GetPlayerNumber();
+	resyncRequestPacket->mismatchFrame = core::ConvertToBinary(newValidateFrame);
+	_packetSenderInterface.SendReliablePacket(std::move(resyncRequestPacket));
+	_isWaitingForResync = true;
+}
+
+void ClientGameManager::ResyncValidatedWorld(const Frame newValidateFrame, const WorldBlob& world,
+                                             const WorldChecksum worldChecksum)
+{
+	_isWaitingForResync = false;
+
+	// The server may have validated frames that were not reached yet, the client skips to them
+	if (newValidateFrame > _currentFrame && newValidateFrame <= _localInputFrame)
+	{
+		_currentFrame = newValidateFrame;
+		_rollbackManager.StartNewFrame(_currentFrame);
+		ScheduleLocalInputFrame();
+	}
+
+	std::erase_if(_pendingValidateFrames, [newValidateFrame](const std::pair<Frame, WorldChecksum>& validateFrame)
+	{
+		return validateFrame.first <= newValidateFrame;
+	});
+
+	// The client validated frames while waiting, the next mismatch asks again for a newer world
+	if (newValidateFrame < _rollbackManager.GetLastValidateFrame() || newValidateFrame > _currentFrame)
+	{
+		core::LogWarning(fmt::format("Resync world of frame {} is out of the rollback window", newValidateFrame));
+		return;
+	}
+
+	const bool isResynced = _rollbackManager.ResyncValidatedWorld(newValidateFrame, world, worldChecksum);
+
+	// The balls spawned only on the server have no sprite yet
+	core::View(_entityManager)
+		.With(static_cast<core::EntityMask>(ComponentType::Bullet))
+		.Without(static_cast<core::EntityMask>(core::ComponentType::Sprite))
+		.ForEach([this](const core::Entity entity)
+		{
+			_transformManager.AddComponent(entity);
+			_transformManager.SetScale(entity, core::Vec2f::One() * BALL_SCALE);
+			_spriteManager.AddComponent(entity);
+			_spriteManager.SetTexture(entity, _ballTexture);
+			_spriteManager.SetOrigin(entity, sf::Vector2f(_ballTexture.getSize()) / 2.0f);
+		});
+
+	if (!isResynced)
+	{
+		_hasResyncFailed = true;
+		core::LogError(fmt::format("Resync at frame {} failed, the following mismatches are not resynced",
+		                           newValidateFrame));
+		return;
+	}
+
+	_resyncCount++;
+	core::LogInfo(fmt::format("Resynced the validated world at frame {}", newValidateFrame));
 }
 
 void ClientGameManager::LoseGame()
@@ -0,0 +1,78 @@
+#include "game/input_predictor.hpp"
+
+#include <limits>
+
+namespace game
+{
+float InputPredictor::GetHitRatio() const
+{
+	const std::size_t total = _hitCount + _missCount;
+	if (total == 0) return 1.0f;
+
+	return static_cast<float>(_hitCount) / static_cast<float>(total);
+}
+
+PlayerInput RepeatLastInputPredictor::PredictInput([[maybe_unused]] PlayerNumber playerNumber,
+                                                   const PlayerInput lastInput,
+                                                   [[maybe_unused]] Frame frameCount) const
+{
+	return lastInput;
+}
+
+PlayerInput MarkovInputPredictor::PredictInput(const PlayerNumber playerNumber, const PlayerInput lastInput,
+                                               const Frame frameCount) const
+{
+	// Follows the most likely transitions until an input is most likely kept
+	PlayerInput input = lastInput;
+	for (Frame frame = 0; frame < frameCount; frame++)
+	{
+		const PlayerInput nextInput = GetMostLikelyInput(playerNumber, input);
+		if (nextInput == input) break;
+
+		input = nextInput;
+	}
+
+	return input;
+}
+
+void MarkovInputPredictor::LearnInput(const PlayerNumber playerNumber, const PlayerInput previousInput,
+                                      const PlayerInput input)
+{
+	auto& counts = _transitionCounts[playerNumber][previousInput % INPUT_NMB];
+	auto& count = counts[input % INPUT_NMB];
+	if (count == std::numeric_limits<std::uint8_t>::max())
+	{
+		for (auto& otherCount : counts)
+		{
+			otherCount /= 2;
+		}
+	}
+
+	count++;
+}
+
+PlayerInput MarkovInputPredictor::GetMostLikelyInput(const PlayerNumber playerNumber, const PlayerInput input) const
+{
+	const auto& counts = _transitionCounts[playerNumber][input % INPUT_NMB];
+
+	// Keeping the input wins the ties, it is the prediction without any data
+	PlayerInput mostLikelyInput = input;
+	for (std::size_t nextInput = 0; nextInput < INPUT_NMB; nextInput++)
+	{
+		if (counts[nextInput] > counts[mostLikelyInput % INPUT_NMB])
+		{
+			mostLikelyInput = static_cast<PlayerInput>(nextInput);
+		}
+	}
+
+	return mostLikelyInput;
+}
+
+PlayerInput ShootReleaseInputPredictor::PredictInput([[maybe_unused]] PlayerNumber playerNumber,
+                                                     const PlayerInput lastInput, const Frame frameCount) const
+{
+	if (frameCount < _releaseFrameCount) return lastInput;
+
+	return static_cast<PlayerInput>(lastInput & ~player_input_enum::Shoot);
+}
+}
@@ -42,7 +42,6 @@ void PlayerCharacterManager::FixedUpdate(const sf::Time deltaTime)
 			static_cast<core::EntityMask>(ComponentType::PlayerCharacter));
 		if (!isPlayer) continue;
 
-		Rigidbody& playerBody = _physicsManager.GetRigidbody(playerEntity);
 		// ReSharper disable once CppUseStructuredBinding
 		PlayerCharacter& playerCharacter = GetComponent(playerEntity);
 		const auto input = playerCharacter.input;
@@ -56,7 +55,7 @@ void PlayerCharacterManager::FixedUpdate(const sf::Time deltaTime)
 		const auto horizontalForce = ((left ? -1.0f : 0.0f) + (right ? 1.0f : 0.0f)) * PLAYER_SPEED;
 		const auto verticalForce = ((down ? -1.0f : 0.0f) + (up ? 1.0f : 0.0f)) * PLAYER_SPEED;
 		const core::Vec2f addedForce{ horizontalForce, verticalForce };
-		playerBody.ApplyForce(addedForce);
+		_physicsManager.ApplyForce(playerEntity, addedForce);
 
 		if (isMoving)
 		{
@@ -65,13 +64,14 @@ void PlayerCharacterManager::FixedUpdate(const sf::Time deltaTime)
 				angle = angle * -1.0f;
 
 			playerCharacter.rotation = angle;
-			playerBody.SetRotation(playerCharacter.rotation);
+			_physicsManager.GetTransform(playerEntity).rotation = playerCharacter.rotation;
 
 			playerCharacter.aimDirection = addedForce.GetNormalized();
 		}
 
 		if (input & player_input_enum::PlayerInput::Shoot && playerCharacter.hasBall)
 		{
+			const Rigidbody playerBody = _physicsManager.GetRigidbody(playerEntity);
 			const auto currentPlayerSpeed = playerBody.Velocity().GetMagnitude();
 			const auto ballVelocity = playerCharacter.aimDirection *
 				((core::Vec2f::Dot(playerBody.Velocity(), playerCharacter.aimDirection) > 0.0f ? currentPlayerSpeed : 0.0f)
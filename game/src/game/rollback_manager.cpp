@@ -1,7 +1,13 @@
+#include <algorithm>
+#include <limits>
+
 #include <fmt/format.h>
 
 #include <game/game_manager.hpp>
 #include <game/rollback_manager.hpp>
+#include <game/speculative_resimulation.hpp>
+
+#include <engine/view.hpp>
 
 #include <utils/log.hpp>
 
@@ -13,174 +19,167 @@
 
 namespace game
 {
-RollbackManager::RollbackManager(GameManager& gameManager, core::EntityManager& entityManager)
+RollbackManager::RollbackManager(GameManager& gameManager, core::EntityManager& entityManager,
+                                 const RollbackMode rollbackMode)
 	: OnTriggerInterface(), OnCollisionInterface(), _gameManager(gameManager), _entityManager(entityManager),
+	  _rollbackMode(rollbackMode),
 	  _currentTransformManager(entityManager),
 	  _currentPhysicsManager(entityManager), _currentPlayerManager(entityManager, _currentPhysicsManager, _gameManager),
 	  _currentBulletManager(entityManager),
 	  _currentFallingObjectManager(entityManager, _currentPhysicsManager),
 	  _currentFallingDoorManager(entityManager, _currentPlayerManager, _gameManager, _currentScoreManager),
 	  _currentDamageManager(entityManager, _currentPlayerManager),
-	  _currentFallingWallSpawnManager(*this, _gameManager),
-	  _lastValidatePhysicsManager(entityManager),
-	  _lastValidatePlayerManager(entityManager, _lastValidatePhysicsManager, _gameManager),
-	  _lastValidateBulletManager(entityManager),
-	  _lastValidateFallingObjectManager(entityManager, _lastValidatePhysicsManager),
-	  _lastValidateFallingDoorManager(entityManager, _lastValidatePlayerManager, _gameManager,
-	                                  _lastValidateScoreManager),
-	  _lastValidateDamageManager(entityManager, _lastValidatePlayerManager),
-	  _lastValidateFallingWallSpawnManager(*this, _gameManager)
+	  _currentFallingWallSpawnManager(*this, _gameManager)
 {
-	for (auto& input : _inputs)
-	{
-		std::ranges::fill(input, '\0');
-	}
+	SetWindowSize(WINDOW_BUFFER_SIZE);
+
+	// The server never restores a frame
+	SetIncrementalRestore(_rollbackMode == RollbackMode::Client);
+
+	// Repeating the last input is the default prediction, the other models only record their hit rate
+	AddInputPredictor(std::make_unique<RepeatLastInputPredictor>());
+	AddInputPredictor(std::make_unique<MarkovInputPredictor>());
+	AddInputPredictor(std::make_unique<ShootReleaseInputPredictor>());
 
 	_currentPhysicsManager.RegisterTriggerListener(*this);
 	_currentPhysicsManager.RegisterCollisionListener(*this);
 	_currentPhysicsManager.RegisterCollisionListener(_currentFallingDoorManager);
-	_lastValidatePhysicsManager.RegisterCollisionListener(_lastValidateFallingDoorManager);
 	_currentPhysicsManager.RegisterCollisionListener(_currentDamageManager);
-	_lastValidatePhysicsManager.RegisterCollisionListener(_lastValidateDamageManager);
+
+	SaveValidatedWorld();
 }
 
+RollbackManager::~RollbackManager() = default;
+
 void RollbackManager::SimulateToCurrentFrame()
 {
 	#ifdef TRACY_ENABLE
 	ZoneScoped;
 	#endif
 
-	const auto currentFrame = _gameManager.GetCurrentFrame();
-	const auto lastValidateFrame = _gameManager.GetLastValidateFrame();
-
-	// Destroying all created Entities after the last validated frame
-	for (const auto& [entity, createdFrame] : _createdEntities)
+	SimulateToFrame(_gameManager.GetCurrentFrame());
+	if (_speculation != nullptr)
 	{
-		if (createdFrame > lastValidateFrame)
-		{
-			_entityManager.DestroyEntity(entity);
-		}
+		StartSpeculation();
 	}
 
-	_createdEntities.clear();
+	// Copy the physics states to the transforms, gathered first so they are written in one batch
+	_syncedEntities.clear();
+	_syncedPositions.clear();
+	_syncedRotations.clear();
+	const RigidbodyManager& rigidbodyManager = _currentPhysicsManager.GetRigidbodyManager();
+	core::View(_entityManager)
+		.With(RigidbodyManager::COMPONENT_FLAG | static_cast<core::EntityMask>(core::ComponentType::Transform))
+		.ForEach([this, &rigidbodyManager](const core::Entity entity)
+		{
+			const Transform& transform = rigidbodyManager.GetTransform(entity);
+			_syncedEntities.push_back(entity);
+			_syncedPositions.push_back(transform.position);
+			_syncedRotations.push_back(transform.rotation);
+		});
+	_currentTransformManager.SetPositions(_syncedEntities, _syncedPositions);
+	_currentTransformManager.SetRotations(_syncedEntities, _syncedRotations);
+}
 
-	// Remove DESTROY flags
-	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
+void RollbackManager::SetPlayerInput(const PlayerNumber playerNumber, const PlayerInput playerInput,
+                                     const Frame inputFrame)
+{
+	// Should only be called on the server
+	if (_currentFrame < inputFrame)
 	{
-		if (_entityManager.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::Destroyed)))
-		{
-			_entityManager.RemoveComponent(entity, static_cast<core::EntityMask>(ComponentType::Destroyed));
-		}
+		StartNewFrame(inputFrame);
 	}
 
-	// Revert the current game state to the last validated game state
-	_currentBulletManager.CopyAllComponents(_lastValidateBulletManager.GetAllComponents());
-	_currentPlayerManager.CopyAllComponents(_lastValidatePlayerManager.GetAllComponents());
-	_currentFallingObjectManager.CopyAllComponents(_lastValidateFallingObjectManager.GetAllComponents());
-	_currentFallingDoorManager.CopyAllComponents(_lastValidateFallingDoorManager.GetAllComponents());
-	_currentPhysicsManager.CopyAllComponents(_lastValidatePhysicsManager);
-	_currentFallingWallSpawnManager.CopyAllComponents(_lastValidateFallingWallSpawnManager);
-	_currentScoreManager.CopyAllComponents(_lastValidateScoreManager);
+	gpr_assert(_currentFrame - inputFrame < _windowSize, "Trying to set input too far in the past");
 
-	for (Frame frame = lastValidateFrame + 1; frame <= currentFrame; frame++)
+	const Frame lastReceivedFrame = _lastReceivedFrame[playerNumber];
+	if (lastReceivedFrame < inputFrame)
 	{
-		_testedFrame = frame;
-
-		// Copy player inputs to player manager
-		for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+		// Every model is scored on the frames that were simulated with a prediction
+		if (inputFrame <= _currentWorldFrame)
 		{
-			const auto playerInput = GetInputAtFrame(playerNumber, frame);
-			const auto playerEntity = _gameManager.GetEntityFromPlayerNumber(playerNumber);
-			if (playerEntity == core::INVALID_ENTITY)
+			const PlayerInput lastReceivedInput = GetInputSlot(playerNumber, lastReceivedFrame);
+			for (const auto& inputPredictor : _inputPredictors)
 			{
-				core::LogWarning(fmt::format("Invalid Entity in {}:line {}", __FILE__, __LINE__));
-				continue;
+				inputPredictor->RecordPrediction(
+					inputPredictor->PredictInput(playerNumber, lastReceivedInput, inputFrame - lastReceivedFrame) ==
+					playerInput);
 			}
-
-			auto& playerCharacter = _currentPlayerManager.GetComponent(playerEntity);
-			playerCharacter.input = playerInput;
 		}
 
-		// Simulate one frame of the game
-		const sf::Time period = sf::seconds(FIXED_PERIOD);
-		_currentPlayerManager.FixedUpdate(period);
-		_currentFallingObjectManager.FixedUpdate(period);
-		_currentPhysicsManager.FixedUpdate(period);
-		_currentFallingWallSpawnManager.FixedUpdate();
-	}
-
-	// Copy the physics states to the transforms
-	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
-	{
-		if (!_entityManager.HasComponent(entity,
-		                                 static_cast<core::EntityMask>(core::ComponentType::Rigidbody) |
-		                                 static_cast<core::EntityMask>(core::ComponentType::Transform)))
-			continue;
-		const Rigidbody& body = _currentPhysicsManager.GetRigidbody(entity);
-		_currentTransformManager.SetPosition(entity, body.Position());
-		_currentTransformManager.SetRotation(entity, body.Rotation());
+		_lastReceivedFrame[playerNumber] = inputFrame;
 	}
-}
 
-void RollbackManager::SetPlayerInput(const PlayerNumber playerNumber, const PlayerInput playerInput,
-                                     const Frame inputFrame)
-{
-	// Should only be called on the server
-	if (_currentFrame < inputFrame)
+	if (GetInputAtFrame(playerNumber, inputFrame) != playerInput)
 	{
-		StartNewFrame(inputFrame);
+		MarkMispredictedFrame(inputFrame);
+		GetInputSlot(playerNumber, inputFrame) = playerInput;
 	}
 
-	const std::size_t frameDifference = static_cast<std::size_t>(_currentFrame) - inputFrame;
+	if (_lastReceivedFrame[playerNumber] != inputFrame) return;
 
-	_inputs[playerNumber][frameDifference] = playerInput;
-	if (_lastReceivedFrame[playerNumber] < inputFrame)
+	// The following frames are predicted again from the new input, older inputs of the same packet correct the skipped frames
+	const InputPredictor& inputPredictor = *_inputPredictors[_activeInputPredictor];
+	for (Frame frame = inputFrame + 1; frame <= _currentFrame; frame++)
 	{
-		_lastReceivedFrame[playerNumber] = inputFrame;
-
-		// Repeat the same inputs until currentFrame
-		for (size_t i = 0; i < frameDifference; i++)
+		const PlayerInput predictedInput = inputPredictor.PredictInput(playerNumber, playerInput, frame - inputFrame);
+		if (GetInputSlot(playerNumber, frame) != predictedInput)
 		{
-			_inputs[playerNumber][i] = playerInput;
+			MarkMispredictedFrame(frame);
+			GetInputSlot(playerNumber, frame) = predictedInput;
 		}
 	}
 }
 
 void RollbackManager::StartNewFrame(const Frame newFrame)
 {
-	#ifdef TRACY_ENABLE
-	ZoneScoped;
-	#endif
-
-	if (_currentFrame > newFrame) return;
+	if (_currentFrame >= newFrame) return;
 
-	const auto delta = newFrame - _currentFrame;
-	if (delta == 0) return;
-
-	for (auto& inputs : _inputs)
+	// The inputs of the new frames are predicted once, so they do not change after being simulated
+	const Frame windowStartFrame = newFrame >= _windowSize ? newFrame - static_cast<Frame>(_windowSize) + 1 : 0;
+	const InputPredictor& inputPredictor = *_inputPredictors[_activeInputPredictor];
+	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
 	{
-		for (auto i = inputs.size() - 1; i >= delta; i--)
+		const Frame lastReceivedFrame = _lastReceivedFrame[playerNumber];
+		const PlayerInput lastReceivedInput = GetInputSlot(playerNumber, lastReceivedFrame);
+		for (Frame frame = std::max({_currentFrame + 1, lastReceivedFrame + 1, windowStartFrame}); frame <= newFrame;
+		     frame++)
 		{
-			inputs[i] = inputs[i - delta];
-		}
-
-		for (Frame i = 0; i < delta; i++)
-		{
-			inputs[i] = inputs[delta];
+			GetInputSlot(playerNumber, frame) = inputPredictor.PredictInput(playerNumber, lastReceivedInput,
+			                                                                frame - lastReceivedFrame);
 		}
 	}
 
 	_currentFrame = newFrame;
 }
 
+void RollbackManager::SetWindowSize(const std::size_t windowSize)
+{
+	gpr_assert(windowSize >= MAX_INPUT_NMB, "The window must contain at least the inputs of a packet");
+	gpr_assert(_currentFrame == 0, "The window size can only be changed before the game starts");
+
+	_windowSize = windowSize;
+	for (auto& inputs : _inputs)
+	{
+		inputs.assign(_windowSize, '\0');
+	}
+
+	// The server never restores a frame of the window
+	_snapshots.clear();
+	_framePredictions.clear();
+	if (_rollbackMode == RollbackMode::Client)
+	{
+		_snapshots.resize(_windowSize);
+		_framePredictions.resize(_windowSize, FramePrediction::None);
+	}
+}
+
 void RollbackManager::ValidateFrame(const Frame newValidateFrame)
 {
 	#ifdef TRACY_ENABLE
 	ZoneScoped;
 	#endif
 
-	const auto lastValidateFrame = _gameManager.GetLastValidateFrame();
-
 	// We check that we got all the inputs
 	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
 	{
@@ -191,136 +190,206 @@ void RollbackManager::ValidateFrame(const Frame newValidateFrame)
 		}
 	}
 
-	// Destroying all created Entities after the last validated frame
-	for (const auto& createdEntity : _createdEntities)
+	if (newValidateFrame <= _lastValidateFrame) return;
+
+	if (_rollbackMode == RollbackMode::Server)
 	{
-		if (createdEntity.createdFrame > lastValidateFrame)
-		{
-			_entityManager.DestroyEntity(createdEntity.entity);
-		}
+		AdvanceValidatedWorld(newValidateFrame);
+		return;
 	}
 
-	_createdEntities.clear();
-	// Remove DESTROYED flag
-	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
+	// The snapshot of the new validated frame only needs to be simulated if it is not up to date
+	if (_lastSimulatedFrame < newValidateFrame)
 	{
-		if (_entityManager.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::Destroyed)))
-		{
-			_entityManager.RemoveComponent(entity, static_cast<core::EntityMask>(ComponentType::Destroyed));
-		}
+		SimulateToFrame(newValidateFrame);
 	}
 
-	_createdEntities.clear();
-
-	// We use the current game state as the temporary new validate game state
-	_currentBulletManager.CopyAllComponents(_lastValidateBulletManager.GetAllComponents());
-	_currentPlayerManager.CopyAllComponents(_lastValidatePlayerManager.GetAllComponents());
-	_currentFallingObjectManager.CopyAllComponents(_lastValidateFallingObjectManager.GetAllComponents());
-	_currentFallingDoorManager.CopyAllComponents(_lastValidateFallingDoorManager.GetAllComponents());
-	_currentDamageManager.CopyAllComponents(_lastValidateDamageManager.GetAllComponents());
-	_currentPhysicsManager.CopyAllComponents(_lastValidatePhysicsManager);
-	_currentFallingWallSpawnManager.CopyAllComponents(_lastValidateFallingWallSpawnManager);
-	_currentScoreManager.CopyAllComponents(_lastValidateScoreManager);
-
-	// We simulate the frames until the new validated frame
+	// The predictions of the new validated frames are final
 	for (Frame frame = _lastValidateFrame + 1; frame <= newValidateFrame; frame++)
 	{
-		_testedFrame = frame;
-		// Copy the players inputs into the player manager
-		for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+		FramePrediction& framePrediction = _framePredictions[frame % _windowSize];
+		if (framePrediction == FramePrediction::Predicted)
+		{
+			_predictionHitCount++;
+		}
+		else if (framePrediction == FramePrediction::Mispredicted)
 		{
-			const auto playerInput = GetInputAtFrame(playerNumber, frame);
-			const auto playerEntity = _gameManager.GetEntityFromPlayerNumber(playerNumber);
-			auto& playerCharacter = _currentPlayerManager.GetComponent(playerEntity);
-			playerCharacter.input = playerInput;
+			_predictionMissCount++;
 		}
 
-		// We simulate one frame
-		const sf::Time period = sf::seconds(FIXED_PERIOD);
-		_currentPlayerManager.FixedUpdate(period);
-		_currentFallingObjectManager.FixedUpdate(period);
-		_currentPhysicsManager.FixedUpdate(period);
-		_currentFallingWallSpawnManager.FixedUpdate();
+		framePrediction = FramePrediction::None;
 	}
 
-	// Definitely remove DESTROY entities
-	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
+	// The validated inputs are final, the prediction models learn from them in order
+	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
 	{
-		if (_entityManager.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::Destroyed)))
+		for (Frame frame = _lastValidateFrame + 1; frame <= newValidateFrame; frame++)
 		{
-			_entityManager.DestroyEntity(entity);
+			for (const auto& inputPredictor : _inputPredictors)
+			{
+				inputPredictor->LearnInput(playerNumber, GetInputSlot(playerNumber, frame - 1),
+				                           GetInputSlot(playerNumber, frame));
+			}
+		}
+	}
+
+	// Copy the snapshot of the new validated frame to the last validated game state
+	LoadSnapshot(newValidateFrame, _lastValidateWorld);
+	_lastValidateChecksum = GetSnapshot(newValidateFrame).checksum;
+
+	// Definitely remove DESTROY entities, the ones destroyed by a previous validation may have been reused since
+	std::size_t offset = sizeof(WorldHeader);
+	const std::size_t destroyedCount = _lastValidateWorld.ReadCount(offset);
+	for (std::size_t i = 0; i < destroyedCount; i++)
+	{
+		const auto destroyedEntity = _lastValidateWorld.Read<DestroyedEntity>(offset);
+		if (destroyedEntity.destroyedFrame > _lastValidateFrame)
+		{
+			DestroyValidatedEntity(destroyedEntity.entity);
 		}
 	}
 
-	// Copy back the new validate game state to the last validated game state
-	_lastValidateBulletManager.CopyAllComponents(_currentBulletManager.GetAllComponents());
-	_lastValidatePlayerManager.CopyAllComponents(_currentPlayerManager.GetAllComponents());
-	_lastValidatePhysicsManager.CopyAllComponents(_currentPhysicsManager);
-	_lastValidateFallingObjectManager.CopyAllComponents(_currentFallingObjectManager.GetAllComponents());
-	_lastValidateFallingDoorManager.CopyAllComponents(_currentFallingDoorManager.GetAllComponents());
-	_lastValidateDamageManager.CopyAllComponents(_currentDamageManager.GetAllComponents());
-	_lastValidateFallingWallSpawnManager.CopyAllComponents(_currentFallingWallSpawnManager);
-	_lastValidateScoreManager.CopyAllComponents(_currentScoreManager);
+	std::erase_if(_destroyedEntities, [newValidateFrame](const DestroyedEntity& destroyedEntity)
+	{
+		return destroyedEntity.destroyedFrame <= newValidateFrame;
+	});
+
+	// Entities created until the new validated frame are now part of the validated world
+	std::erase_if(_createdEntities, [newValidateFrame](const CreatedEntity& createdEntity)
+	{
+		return createdEntity.createdFrame <= newValidateFrame;
+	});
+
 	_lastValidateFrame = newValidateFrame;
-	_createdEntities.clear();
 }
 
-void RollbackManager::ConfirmFrame(Frame newValidatedFrame,
-                                   const std::array<PhysicsState, MAX_PLAYER_NMB>& serverPhysicsState)
+bool RollbackManager::ConfirmFrame(const Frame newValidatedFrame, const WorldChecksum serverChecksum)
 {
 	#ifdef TRACY_ENABLE
 	ZoneScoped;
 	#endif
 
 	ValidateFrame(newValidatedFrame);
-	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+	if (serverChecksum != _lastValidateChecksum)
 	{
-		const PhysicsState lastPhysicsState = GetValidatePhysicsState(playerNumber);
-		if (serverPhysicsState[playerNumber] != lastPhysicsState)
-		{
-			gpr_assert(false,
-			           fmt::format(
-				           "Physics State are not equal for player {} (server frame: {}, client frame: {}, server: {}, client: {})",
-				           playerNumber + 1,
-				           newValidatedFrame,
-				           _lastValidateFrame,
-				           serverPhysicsState[playerNumber],
-				           lastPhysicsState));
-		}
+		core::LogWarning(fmt::format(
+			"World checksums are not equal (server frame: {}, client frame: {}, server: {:016x}, client: {:016x})",
+			newValidatedFrame,
+			_lastValidateFrame,
+			serverChecksum,
+			_lastValidateChecksum));
+		return false;
 	}
+
+	return true;
 }
 
-PhysicsState RollbackManager::GetValidatePhysicsState(const PlayerNumber playerNumber) const
+void RollbackManager::WriteValidatedWorld(WorldBlob& world) const
 {
-	PhysicsState state = 0;
-	const core::Entity playerEntity = _gameManager.GetEntityFromPlayerNumber(playerNumber);
-	const Rigidbody& rigidbody = _lastValidatePhysicsManager.GetRigidbody(playerEntity);
+	gpr_assert(_rollbackMode == RollbackMode::Server, "Only the server can send its validated world");
+
+	// The current world of the server is the validated world
+	SaveWorld(world);
+	const auto worldSize = static_cast<std::uint32_t>(world.GetSize());
+	const auto entityMasks = _entityManager.GetEntityMasks();
+	world.Write(std::vector<core::EntityMask>(entityMasks.begin(), entityMasks.end()));
+	world.Write(worldSize);
+}
 
-	const auto& pos = rigidbody.Position();
-	const auto* posPtr = reinterpret_cast<const PhysicsState*>(&pos);
+bool RollbackManager::ResyncValidatedWorld(const Frame newValidateFrame, const WorldBlob& world,
+                                           const WorldChecksum serverChecksum)
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	gpr_assert(_rollbackMode == RollbackMode::Client, "Only the clients can be resynchronized");
+	if (newValidateFrame < _lastValidateFrame || newValidateFrame > _currentFrame)
+	{
+		core::LogWarning(fmt::format("Cannot resync to frame {} (validated frame: {}, current frame: {})",
+		                             newValidateFrame, _lastValidateFrame, _currentFrame));
+		return false;
+	}
 
-	// Adding position
-	for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
+	// Bring the current world to the resync frame, so the same entities as on the server were created
+	if (_currentWorldFrame != newValidateFrame)
 	{
-		state += posPtr[i];
+		SimulateToFrame(newValidateFrame);
 	}
 
-	// Adding velocity
-	const auto* velocityPtr = reinterpret_cast<const PhysicsState*>(&rigidbody.Velocity());
-	for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
+	// Definitely remove DESTROY entities, the server removes them when validating
+	for (const auto& [entity, destroyedFrame] : _destroyedEntities)
 	{
-		state += velocityPtr[i];
+		DestroyValidatedEntity(entity);
 	}
 
-	// Adding rotation
-	const auto angle = rigidbody.Trans().rotation.Value();
-	const auto* anglePtr = reinterpret_cast<const PhysicsState*>(&angle);
-	for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
+	_destroyedEntities.clear();
+
+	std::erase_if(_createdEntities, [newValidateFrame](const CreatedEntity& createdEntity)
+	{
+		return createdEntity.createdFrame <= newValidateFrame;
+	});
+
+	if (_speculation != nullptr)
 	{
-		state += anglePtr[i];
+		_speculation->Invalidate();
 	}
 
-	return state;
+	// The entities caught or spawned on only one side are created or destroyed like on the server,
+	// before loading the world so the sparse set keeps their components
+	std::size_t offset = world.GetSize() - sizeof(std::uint32_t);
+	const std::size_t worldSize = world.Read<std::uint32_t>(offset);
+	offset = worldSize;
+	std::vector<core::EntityMask> entityMasks(world.ReadCount(offset));
+	world.Read(offset, std::span(entityMasks));
+	std::vector<core::Entity> createdEntities;
+	for (core::Entity entity = 0; entity < entityMasks.size(); entity++)
+	{
+		const bool isCreated = entityMasks[entity] != core::INVALID_ENTITY_MASK &&
+			(entity >= _entityManager.GetEntitiesSize() || !_entityManager.EntityExists(entity));
+		if (isCreated)
+		{
+			createdEntities.push_back(entity);
+		}
+	}
+
+	_entityManager.SetEntityMasks(entityMasks, CLIENT_COMPONENT_MASK);
+
+	// The transforms of the new entities are not in the serialized world, their arrays may need to grow
+	for (const core::Entity entity : createdEntities)
+	{
+		if (_entityManager.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::Transform)))
+		{
+			_currentTransformManager.AddComponent(entity);
+		}
+	}
+
+	_lastValidateWorld.Assign(world.GetData(), worldSize);
+	_currentWorld = _lastValidateWorld;
+	LoadWorld(_lastValidateWorld);
+	ClearDirty(newValidateFrame);
+	_lastValidateChecksum = ComputeChecksum();
+
+	// The frames replaced by the world of the server are not counted as predictions
+	for (Frame frame = _lastValidateFrame + 1; frame <= newValidateFrame; frame++)
+	{
+		_framePredictions[frame % _windowSize] = FramePrediction::None;
+	}
+
+	// The snapshots were simulated from the desynced world, the window is resimulated from the new validated frame
+	_lastValidateFrame = newValidateFrame;
+	_lastSimulatedFrame = newValidateFrame;
+	_currentWorldFrame = newValidateFrame;
+
+	if (_lastValidateChecksum != serverChecksum)
+	{
+		core::LogWarning(fmt::format(
+			"Resync world of frame {} does not match the server checksum (server: {:016x}, client: {:016x})",
+			newValidateFrame, serverChecksum, _lastValidateChecksum));
+		return false;
+	}
+
+	return true;
 }
 
 void RollbackManager::SetupLevel(const core::Entity wallLeftEntity, const core::Entity wallRightEntity,
@@ -334,7 +403,8 @@ void RollbackManager::SetupLevel(const core::Entity wallLeftEntity, const core::
 	CreateWall(wallTopEntity, WALL_TOP_POS, HORIZONTAL_WALLS_SIZE);
 
 	_currentDamageManager.AddComponent(wallBottomEntity);
-	_lastValidateDamageManager.AddComponent(wallBottomEntity);
+
+	SaveValidatedWorld();
 }
 
 void RollbackManager::SpawnFallingWall(const core::Entity backgroundWall, const core::Entity door, float doorPosition,
@@ -407,11 +477,6 @@ void RollbackManager::CreateWall(const core::Entity entity, const core::Vec2f po
 	_currentPhysicsManager.AddAabbCollider(entity);
 	_currentPhysicsManager.SetAabbCollider(entity, wallCollider);
 
-	_lastValidatePhysicsManager.AddRigidbody(entity);
-	_lastValidatePhysicsManager.SetRigidbody(entity, wallBody);
-	_lastValidatePhysicsManager.AddAabbCollider(entity);
-	_lastValidatePhysicsManager.SetAabbCollider(entity, wallCollider);
-
 	_currentTransformManager.AddComponent(entity);
 	_currentTransformManager.SetPosition(entity, position);
 }
@@ -448,29 +513,738 @@ void RollbackManager::SpawnPlayer(const PlayerNumber playerNumber, const core::E
 	_currentPhysicsManager.AddCircleCollider(entity);
 	_currentPhysicsManager.SetCircleCollider(entity, playerCircle);
 
-	_lastValidatePlayerManager.AddComponent(entity);
-	_lastValidatePlayerManager.SetComponent(entity, playerCharacter);
-
-	_lastValidatePhysicsManager.AddRigidbody(entity);
-	_lastValidatePhysicsManager.SetRigidbody(entity, playerBody);
-	_lastValidatePhysicsManager.AddCircleCollider(entity);
-	_lastValidatePhysicsManager.SetCircleCollider(entity, playerCircle);
-
 	_currentTransformManager.AddComponent(entity);
 	_currentTransformManager.SetPosition(entity, position);
 	_currentTransformManager.SetRotation(entity, rotation);
 
 	_currentFallingObjectManager.AddComponent(entity);
-	_lastValidateFallingObjectManager.AddComponent(entity);
+
+	SaveValidatedWorld();
 }
 
 PlayerInput RollbackManager::GetInputAtFrame(const PlayerNumber playerNumber, const Frame frame) const
 {
-	const std::size_t frameDifference = static_cast<std::size_t>(_currentFrame) - frame;
-
-	gpr_assert(frameDifference < _inputs[playerNumber].size(),
+	gpr_assert(static_cast<std::size_t>(_currentFrame) - frame < _windowSize,
 	           "Trying to get input too far in the past");
-	return _inputs[playerNumber][frameDifference];
+
+	// Inputs after the last received frame were stored with their prediction
+	return _inputs[playerNumber][frame % _windowSize];
+}
+
+void RollbackManager::SimulateToFrame(const Frame targetFrame)
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	if (_speculation != nullptr && _lastSimulatedFrame < targetFrame)
+	{
+		ApplySpeculation(targetFrame);
+	}
+
+	const Frame restoredFrame = std::min(_lastSimulatedFrame, targetFrame);
+	if (_currentWorldFrame != restoredFrame)
+	{
+		// Revert the current game state to the last correctly simulated frame
+		_rollbackDepth = _currentWorldFrame > restoredFrame ? _currentWorldFrame - restoredFrame : 0;
+		_maxRollbackDepth = std::max(_maxRollbackDepth, _rollbackDepth);
+		RestoreFrame(restoredFrame);
+	}
+
+	for (Frame frame = restoredFrame + 1; frame <= targetFrame; frame++)
+	{
+		SimulateFrame(frame);
+		SaveSnapshot(frame);
+
+		// A frame keeps its misprediction when it is resimulated with new predictions
+		FramePrediction& framePrediction = _framePredictions[frame % _windowSize];
+		const bool isPredicted = std::ranges::any_of(_lastReceivedFrame, [frame](const Frame lastReceivedFrame)
+		{
+			return lastReceivedFrame < frame;
+		});
+		if (isPredicted && framePrediction == FramePrediction::None)
+		{
+			framePrediction = FramePrediction::Predicted;
+		}
+	}
+
+	_lastSimulatedFrame = std::max(_lastSimulatedFrame, targetFrame);
+	_currentWorldFrame = targetFrame;
+}
+
+void RollbackManager::SimulateFrame(const Frame frame)
+{
+	_testedFrame = frame;
+
+	// Copy player inputs to player manager
+	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+	{
+		const auto playerInput = GetInputAtFrame(playerNumber, frame);
+		const auto playerEntity = _gameManager.GetEntityFromPlayerNumber(playerNumber);
+		if (playerEntity == core::INVALID_ENTITY)
+		{
+			core::LogWarning(fmt::format("Invalid Entity in {}:line {}", __FILE__, __LINE__));
+			continue;
+		}
+
+		auto& playerCharacter = _currentPlayerManager.GetComponent(playerEntity);
+		playerCharacter.input = playerInput;
+	}
+
+	// Simulate one frame of the game
+	const sf::Time period = sf::seconds(FIXED_PERIOD);
+	_currentPlayerManager.FixedUpdate(period);
+	_currentFallingObjectManager.FixedUpdate(period);
+	_currentPhysicsManager.FixedUpdate(period);
+	_currentFallingWallSpawnManager.FixedUpdate();
+}
+
+std::size_t RollbackManager::AddInputPredictor(std::unique_ptr<InputPredictor> inputPredictor)
+{
+	_inputPredictors.push_back(std::move(inputPredictor));
+	return _inputPredictors.size() - 1;
+}
+
+void RollbackManager::SetActiveInputPredictor(const std::size_t index)
+{
+	gpr_assert(index < _inputPredictors.size(), "Invalid input predictor");
+	_activeInputPredictor = index;
+}
+
+void RollbackManager::SetSpeculationHypothesisCount(const std::size_t hypothesisCount)
+{
+	gpr_assert(_rollbackMode == RollbackMode::Client, "Only the clients predict the remote inputs");
+	if (hypothesisCount == GetSpeculationHypothesisCount()) return;
+
+	// Waits for the running timelines before destroying them
+	_speculation.reset();
+	if (hypothesisCount > 0)
+	{
+		_speculation = std::make_unique<SpeculativeResimulation>(hypothesisCount, _windowSize);
+	}
+}
+
+std::size_t RollbackManager::GetSpeculationHypothesisCount() const
+{
+	return _speculation != nullptr ? _speculation->GetHypotheses().size() : 0;
+}
+
+void RollbackManager::StartSpeculation()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	if (_speculation->IsRunning()) return;
+
+	// The remote player is the one whose inputs are predicted the furthest, the others need all their inputs
+	PlayerNumber remotePlayer = 0;
+	for (PlayerNumber playerNumber = 1; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+	{
+		if (_lastReceivedFrame[playerNumber] < _lastReceivedFrame[remotePlayer])
+		{
+			remotePlayer = playerNumber;
+		}
+	}
+
+	const Frame baseFrame = _lastReceivedFrame[remotePlayer];
+	const Frame targetFrame = _currentFrame;
+	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+	{
+		if (playerNumber != remotePlayer && _lastReceivedFrame[playerNumber] < targetFrame) return;
+	}
+
+	// The entities created after the base frame are not in its world
+	const bool hasCreatedEntities = std::ranges::any_of(_createdEntities,
+	                                                    [baseFrame](const CreatedEntity& createdEntity)
+	                                                    {
+		                                                    return createdEntity.createdFrame > baseFrame;
+	                                                    });
+	if (baseFrame >= targetFrame || baseFrame > _lastSimulatedFrame || hasCreatedEntities) return;
+
+	std::array<core::Entity, MAX_PLAYER_NMB> playerEntityMap{};
+	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+	{
+		playerEntityMap[playerNumber] = _gameManager.GetEntityFromPlayerNumber(playerNumber);
+	}
+
+	auto& hypotheses = _speculation->GetHypotheses();
+	for (std::size_t i = 0; i < hypotheses.size(); i++)
+	{
+		SpeculativeHypothesis& hypothesis = hypotheses[i];
+		hypothesis.gameManager->SetPlayerEntities(playerEntityMap);
+
+		// The timeline starts as a copy of the base frame, without the DESTROY flags of the current world
+		RollbackManager& speculation = hypothesis.gameManager->GetRollbackManager();
+		speculation._entityManager = _entityManager;
+		for (const auto& [entity, destroyedFrame] : _destroyedEntities)
+		{
+			speculation._entityManager.RemoveComponent(entity,
+			                                           static_cast<core::EntityMask>(ComponentType::Destroyed));
+		}
+
+		// The DESTROY flags of the base world are put back up to the frame validated in the current world
+		speculation._destroyedEntities.clear();
+		speculation._lastValidateFrame = _lastValidateFrame;
+
+		if (baseFrame == _lastValidateFrame)
+		{
+			speculation._lastValidateWorld = _lastValidateWorld;
+		}
+		else
+		{
+			LoadSnapshot(baseFrame, speculation._lastValidateWorld);
+		}
+
+		speculation._currentWorld = speculation._lastValidateWorld;
+		speculation.LoadWorld(speculation._lastValidateWorld);
+		speculation.ClearDirty(baseFrame);
+		speculation._createdEntities.clear();
+		speculation._lastValidateFrame = baseFrame;
+		speculation._lastSimulatedFrame = baseFrame;
+		speculation._currentWorldFrame = baseFrame;
+		speculation._currentFrame = targetFrame;
+
+		// The remote player changes its input right after its last received frame and keeps it
+		speculation._inputs = _inputs;
+		speculation._lastReceivedFrame = _lastReceivedFrame;
+		speculation._lastReceivedFrame[remotePlayer] = targetFrame;
+		hypothesis.remoteInput = SpeculativeResimulation::GetRemoteInput(GetInputSlot(remotePlayer, baseFrame), i);
+		for (Frame frame = baseFrame + 1; frame <= targetFrame; frame++)
+		{
+			speculation.GetInputSlot(remotePlayer, frame) = hypothesis.remoteInput;
+		}
+
+		hypothesis.baseDestroyedCount = speculation._destroyedEntities.size();
+
+		hypothesis.job = std::async(std::launch::async, [&speculation, targetFrame]
+		{
+			speculation.SimulateToFrame(targetFrame);
+		});
+	}
+
+	_speculation->Start(baseFrame, targetFrame);
+}
+
+void RollbackManager::ApplySpeculation(const Frame targetFrame)
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	if (!_speculation->HasResults()) return;
+
+	// The frames before the base frame of the timelines were mispredicted, they cannot be used anymore
+	const Frame baseFrame = _speculation->GetBaseFrame();
+	if (_lastSimulatedFrame < baseFrame || _lastSimulatedFrame < _lastValidateFrame)
+	{
+		_speculation->Invalidate();
+		return;
+	}
+
+	const Frame lastSpeculatedFrame = std::min(_speculation->GetTargetFrame(), targetFrame);
+	if (_lastSimulatedFrame >= lastSpeculatedFrame) return;
+
+	for (SpeculativeHypothesis& hypothesis : _speculation->GetHypotheses())
+	{
+		RollbackManager& speculation = hypothesis.gameManager->GetRollbackManager();
+
+		bool isMatching = speculation._createdEntities.empty();
+		for (Frame frame = baseFrame + 1; frame <= lastSpeculatedFrame && isMatching; frame++)
+		{
+			for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+			{
+				isMatching &= GetInputAtFrame(playerNumber, frame) == speculation.GetInputAtFrame(playerNumber, frame);
+			}
+		}
+
+		if (!isMatching) continue;
+
+		// Entities destroyed in the timeline could be reused by the entities created in the current world
+		if (speculation._destroyedEntities.size() != hypothesis.baseDestroyedCount) continue;
+
+		// The world is read before its snapshots are swapped
+		if (lastSpeculatedFrame == speculation._currentWorldFrame)
+		{
+			_savedWorld = speculation._currentWorld;
+		}
+		else
+		{
+			speculation.LoadSnapshot(lastSpeculatedFrame, _savedWorld);
+		}
+
+		// The deltas of the timeline are against its own blobs, which differ from the ones of this window,
+		// so the first swapped frame is stored whole and the following deltas are only applied on top of it
+		WorldSnapshot& firstSnapshot = speculation.GetSnapshot(_lastSimulatedFrame + 1);
+		if (!firstSnapshot.isKeyframe)
+		{
+			speculation.LoadSnapshot(_lastSimulatedFrame + 1, firstSnapshot.keyframe);
+			firstSnapshot.isKeyframe = true;
+		}
+
+		for (Frame frame = _lastSimulatedFrame + 1; frame <= lastSpeculatedFrame; frame++)
+		{
+			std::swap(GetSnapshot(frame), speculation.GetSnapshot(frame));
+		}
+
+		// The timeline did not create entities, the ones created after the last correct frame were mispredicted
+		RestoreEntities(_lastSimulatedFrame);
+		std::swap(_currentWorld, _savedWorld);
+		LoadWorld(_currentWorld);
+		ClearDirty(lastSpeculatedFrame);
+
+		_lastSimulatedFrame = lastSpeculatedFrame;
+		_currentWorldFrame = lastSpeculatedFrame;
+		_speculationHitCount++;
+		_speculation->Invalidate();
+		return;
+	}
+}
+
+void RollbackManager::RestoreFrame(const Frame frame)
+{
+	RestoreEntities(frame);
+
+	if (frame == _lastValidateFrame)
+	{
+		_currentWorld = _lastValidateWorld;
+	}
+	else
+	{
+		LoadSnapshot(frame, _currentWorld);
+	}
+
+	// The components not modified since the dirty frame are equal in all the frames after it
+	if (_isIncrementalRestore && frame >= _dirtyFrame)
+	{
+		LoadDirtyWorld(_currentWorld);
+	}
+	else
+	{
+		LoadWorld(_currentWorld);
+	}
+
+	ClearDirty(frame);
+}
+
+void RollbackManager::RestoreEntities(const Frame frame)
+{
+	// Destroying all created Entities after the restored frame
+	for (const auto& [entity, createdFrame] : _createdEntities)
+	{
+		if (createdFrame > frame)
+		{
+			_entityManager.DestroyEntity(entity);
+		}
+	}
+
+	std::erase_if(_createdEntities, [frame](const CreatedEntity& createdEntity)
+	{
+		return createdEntity.createdFrame > frame;
+	});
+
+	// Remove DESTROY flags, the ones of the restored frame are put back by its world
+	for (const auto& [entity, destroyedFrame] : _destroyedEntities)
+	{
+		_entityManager.RemoveComponent(entity, static_cast<core::EntityMask>(ComponentType::Destroyed));
+	}
+
+	_destroyedEntities.clear();
+}
+
+void RollbackManager::SaveSnapshot(const Frame frame)
+{
+	SaveWorld(_savedWorld);
+
+	WorldSnapshot& snapshot = GetSnapshot(frame);
+	std::size_t offset = 0;
+	snapshot.header = _savedWorld.Read<WorldHeader>(offset);
+	snapshot.worldSize = _savedWorld.GetSize();
+	snapshot.isKeyframe = frame % SNAPSHOT_KEYFRAME_INTERVAL == 0;
+	snapshot.checksum = ComputeChecksum();
+	if (snapshot.isKeyframe)
+	{
+		snapshot.keyframe = _savedWorld;
+	}
+	else
+	{
+		// The header is stored aside and not part of the delta
+		_savedWorld.WriteDelta(_currentWorld, sizeof(WorldHeader), snapshot.delta);
+	}
+
+	std::swap(_currentWorld, _savedWorld);
+}
+
+void RollbackManager::LoadSnapshot(const Frame frame, WorldBlob& world)
+{
+	// Find the closest keyframe, the frame after the validated frame is a delta against the validated world
+	Frame baseFrame = frame;
+	while (!GetSnapshot(baseFrame).isKeyframe && baseFrame > _lastValidateFrame + 1)
+	{
+		baseFrame--;
+	}
+
+	const WorldSnapshot& baseSnapshot = GetSnapshot(baseFrame);
+	if (baseSnapshot.isKeyframe)
+	{
+		world = baseSnapshot.keyframe;
+	}
+	else
+	{
+		world = _lastValidateWorld;
+		world.ApplyDelta(baseSnapshot.delta, baseSnapshot.worldSize);
+	}
+
+	for (Frame deltaFrame = baseFrame + 1; deltaFrame <= frame; deltaFrame++)
+	{
+		const WorldSnapshot& snapshot = GetSnapshot(deltaFrame);
+		world.ApplyDelta(snapshot.delta, snapshot.worldSize);
+	}
+
+	world.Overwrite(0, GetSnapshot(frame).header);
+}
+
+WorldChecksum RollbackManager::ComputeChecksum() const
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	// Each component array is hashed in its own builder, so the hashes of an Entity do not wait for each other
+	WorldChecksumBuilder rigidbodyChecksum;
+	WorldChecksumBuilder colliderChecksum;
+	WorldChecksumBuilder playerChecksum;
+	WorldChecksumBuilder fallingChecksum;
+
+	const RigidbodyManager& rigidbodyManager = _currentPhysicsManager.GetRigidbodyManager();
+	const auto& aabbColliders = _currentPhysicsManager.GetAllAabbColliders();
+	const auto& circleColliders = _currentPhysicsManager.GetAllCircleColliders();
+	const auto entityMasks = _entityManager.GetEntityMasks();
+
+	// Destroyed entities are skipped, the server removes them earlier than the clients
+	core::View(_entityManager).Without(static_cast<core::EntityMask>(ComponentType::Destroyed)).ForEach(
+		[&](const core::Entity entity)
+		{
+			const core::EntityMask mask = entityMasks[entity];
+			const auto hasComponent = [mask](const auto component)
+			{
+				const auto componentMask = static_cast<core::EntityMask>(component);
+				return (mask & componentMask) == componentMask;
+			};
+
+			if (hasComponent(core::ComponentType::Rigidbody))
+			{
+				const Transform& transform = rigidbodyManager.GetTransform(entity);
+				rigidbodyChecksum.Add(entity);
+				rigidbodyChecksum.Add(transform.position);
+				rigidbodyChecksum.Add(rigidbodyManager.GetVelocity(entity));
+				rigidbodyChecksum.Add(rigidbodyManager.GetForce(entity));
+				rigidbodyChecksum.Add(transform.rotation);
+				rigidbodyChecksum.Add(rigidbodyManager.GetProperties(entity).bodyType);
+			}
+
+			if (hasComponent(core::ComponentType::AabbCollider))
+			{
+				const AabbCollider& collider = aabbColliders[entity];
+				colliderChecksum.Add(entity);
+				colliderChecksum.Add(collider.center);
+				colliderChecksum.Add(collider.halfWidth);
+				colliderChecksum.Add(collider.halfHeight);
+			}
+
+			if (hasComponent(core::ComponentType::CircleCollider))
+			{
+				const CircleCollider& collider = circleColliders[entity];
+				colliderChecksum.Add(entity);
+				colliderChecksum.Add(collider.center);
+				colliderChecksum.Add(collider.radius);
+			}
+
+			if (hasComponent(ComponentType::PlayerCharacter))
+			{
+				const PlayerCharacter& player = _currentPlayerManager.GetComponent(entity);
+				playerChecksum.Add(entity);
+				playerChecksum.Add(player.input);
+				playerChecksum.Add(player.isDead);
+				playerChecksum.Add(player.hasBall);
+				playerChecksum.Add(player.rotation);
+				playerChecksum.Add(player.aimDirection);
+			}
+
+			if (hasComponent(ComponentType::Bullet))
+			{
+				playerChecksum.Add(entity);
+			}
+
+			if (hasComponent(ComponentType::FallingObject))
+			{
+				fallingChecksum.Add(entity);
+				fallingChecksum.Add(_currentFallingObjectManager.GetComponent(entity).fallingSpeed);
+			}
+
+			if (hasComponent(ComponentType::FallingDoor))
+			{
+				const FallingDoor& door = _currentFallingDoorManager.GetComponent(entity);
+				fallingChecksum.Add(entity);
+				fallingChecksum.Add(door.backgroundWallEntity);
+				fallingChecksum.Add(door.requiresBall);
+			}
+
+			if (hasComponent(ComponentType::Damager))
+			{
+				fallingChecksum.Add(entity);
+				fallingChecksum.Add(_currentDamageManager.GetComponent(entity).damageAmount);
+			}
+		});
+
+	WorldChecksumBuilder checksum;
+	checksum.Add(_currentScoreManager.GetScore());
+	checksum.Combine(rigidbodyChecksum);
+	checksum.Combine(colliderChecksum);
+	checksum.Combine(playerChecksum);
+	checksum.Combine(fallingChecksum);
+	return checksum.GetChecksum();
+}
+
+void RollbackManager::SaveWorld(WorldBlob& world) const
+{
+	world.Clear();
+
+	WorldHeader header;
+	header.fallingWallSpawnInstructions = _currentFallingWallSpawnManager.GetNextFallingWallSpawnInstructions();
+	header.hasFallingWallSpawned = _currentFallingWallSpawnManager.HasSpawned();
+	header.scoreManager.CopyAllComponents(_currentScoreManager);
+	world.Write(header);
+
+	// The DESTROY flags are saved, entities are only truly destroyed when their frame is validated
+	world.Write(_destroyedEntities);
+
+	const RigidbodyManager& rigidbodyManager = _currentPhysicsManager.GetRigidbodyManager();
+	world.Write(rigidbodyManager.GetTransformArray().GetAllComponents());
+	world.Write(rigidbodyManager.GetVelocityArray().GetAllComponents());
+	world.Write(rigidbodyManager.GetForceArray().GetAllComponents());
+	world.Write(rigidbodyManager.GetPropertiesArray().GetAllComponents());
+	world.Write(_currentPhysicsManager.GetAllAabbColliders());
+	world.Write(_currentPhysicsManager.GetAllCircleColliders());
+	world.Write(_currentPlayerManager.GetAllComponents());
+	world.Write(_currentBulletManager.GetAllComponents());
+	world.Write(_currentFallingObjectManager.GetAllEntities());
+	world.Write(_currentFallingObjectManager.GetAllComponents());
+	world.Write(_currentFallingDoorManager.GetAllComponents());
+	world.Write(_currentDamageManager.GetAllComponents());
+}
+
+void RollbackManager::LoadWorld(const WorldBlob& world)
+{
+	std::size_t offset = LoadWorldHeader(world);
+
+	// Each component array is copied directly in its manager
+	RigidbodyManager& rigidbodyManager = _currentPhysicsManager.GetRigidbodyManager();
+	world.Read(offset, rigidbodyManager.GetTransformArray().ResizeAllComponents(world.ReadCount(offset)));
+	world.Read(offset, rigidbodyManager.GetVelocityArray().ResizeAllComponents(world.ReadCount(offset)));
+	world.Read(offset, rigidbodyManager.GetForceArray().ResizeAllComponents(world.ReadCount(offset)));
+	world.Read(offset, rigidbodyManager.GetPropertiesArray().ResizeAllComponents(world.ReadCount(offset)));
+	world.Read(offset, _currentPhysicsManager.ResizeAllAabbColliders(world.ReadCount(offset)));
+	world.Read(offset, _currentPhysicsManager.ResizeAllCircleColliders(world.ReadCount(offset)));
+	world.Read(offset, _currentPlayerManager.ResizeAllComponents(world.ReadCount(offset)));
+	world.Read(offset, _currentBulletManager.ResizeAllComponents(world.ReadCount(offset)));
+	world.Read(offset, _currentFallingObjectManager.ResizeAllEntities(world.ReadCount(offset)));
+	world.Read(offset, _currentFallingObjectManager.ResizeAllComponents(world.ReadCount(offset)));
+	_currentFallingObjectManager.RebuildIndices();
+	_currentFallingObjectManager.RemoveDestroyedComponents();
+	world.Read(offset, _currentFallingDoorManager.ResizeAllComponents(world.ReadCount(offset)));
+	world.Read(offset, _currentDamageManager.ResizeAllComponents(world.ReadCount(offset)));
+}
+
+void RollbackManager::LoadDirtyWorld(const WorldBlob& world)
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	std::size_t offset = LoadWorldHeader(world);
+
+	// Only the dirty components are read, the arrays are never shrunk
+	RigidbodyManager& rigidbodyManager = _currentPhysicsManager.GetRigidbodyManager();
+	rigidbodyManager.GetTransformArray().RestoreDirtyComponents(world.ReadElements<Transform>(offset));
+	rigidbodyManager.GetVelocityArray().RestoreDirtyComponents(world.ReadElements<core::Vec2f>(offset));
+	rigidbodyManager.GetForceArray().RestoreDirtyComponents(world.ReadElements<core::Vec2f>(offset));
+	rigidbodyManager.GetPropertiesArray().RestoreDirtyComponents(world.ReadElements<RigidbodyProperties>(offset));
+	_currentPhysicsManager.RestoreDirtyAabbColliders(world.ReadElements<AabbCollider>(offset));
+	_currentPhysicsManager.RestoreDirtyCircleColliders(world.ReadElements<CircleCollider>(offset));
+	_currentPlayerManager.RestoreDirtyComponents(world.ReadElements<PlayerCharacter>(offset));
+	_currentBulletManager.RestoreDirtyComponents(world.ReadElements<Ball>(offset));
+
+	// The sparse set only holds the few falling objects, it is copied whole
+	world.Read(offset, _currentFallingObjectManager.ResizeAllEntities(world.ReadCount(offset)));
+	world.Read(offset, _currentFallingObjectManager.ResizeAllComponents(world.ReadCount(offset)));
+	_currentFallingObjectManager.RebuildIndices();
+	_currentFallingObjectManager.RemoveDestroyedComponents();
+	_currentFallingDoorManager.RestoreDirtyComponents(world.ReadElements<FallingDoor>(offset));
+	_currentDamageManager.RestoreDirtyComponents(world.ReadElements<Damager>(offset));
+}
+
+std::size_t RollbackManager::LoadWorldHeader(const WorldBlob& world)
+{
+	std::size_t offset = 0;
+	const auto header = world.Read<WorldHeader>(offset);
+	_currentFallingWallSpawnManager.CopyAllComponents(header.fallingWallSpawnInstructions,
+	                                                  header.hasFallingWallSpawned);
+	_currentScoreManager.CopyAllComponents(header.scoreManager);
+
+	// Put back the DESTROY flags, entities destroyed by a validation since the world was saved do not exist anymore
+	gpr_assert(_destroyedEntities.empty(), "The DESTROY flags must be removed before loading a world");
+	const std::size_t destroyedCount = world.ReadCount(offset);
+	for (std::size_t i = 0; i < destroyedCount; i++)
+	{
+		const auto destroyedEntity = world.Read<DestroyedEntity>(offset);
+		if (destroyedEntity.destroyedFrame > _lastValidateFrame)
+		{
+			_entityManager.AddComponent(destroyedEntity.entity,
+			                            static_cast<core::EntityMask>(ComponentType::Destroyed));
+			_destroyedEntities.push_back(destroyedEntity);
+		}
+	}
+
+	return offset;
+}
+
+void RollbackManager::ClearDirty(const Frame frame)
+{
+	_currentPhysicsManager.ClearDirty();
+	_currentPlayerManager.ClearDirty();
+	_currentBulletManager.ClearDirty();
+	_currentFallingDoorManager.ClearDirty();
+	_currentDamageManager.ClearDirty();
+	_dirtyFrame = frame;
+}
+
+void RollbackManager::SetIncrementalRestore(const bool isIncrementalRestore)
+{
+	_isIncrementalRestore = isIncrementalRestore;
+	_currentPhysicsManager.SetDirtyTracking(_isIncrementalRestore);
+	_currentPlayerManager.SetDirtyTracking(_isIncrementalRestore);
+	_currentBulletManager.SetDirtyTracking(_isIncrementalRestore);
+	_currentFallingDoorManager.SetDirtyTracking(_isIncrementalRestore);
+	_currentDamageManager.SetDirtyTracking(_isIncrementalRestore);
+
+	// The components modified before were not tracked, the next restore copies the whole arrays
+	_dirtyFrame = std::numeric_limits<Frame>::max();
+}
+
+void RollbackManager::SaveValidatedWorld()
+{
+	gpr_assert(_currentWorldFrame == _lastValidateFrame,
+	           "Entities can only be added to the validated world when the current world is at the validated frame");
+	SaveWorld(_lastValidateWorld);
+	_currentWorld = _lastValidateWorld;
+	_lastValidateChecksum = ComputeChecksum();
+	ClearDirty(_lastValidateFrame);
+
+	// The snapshots do not contain the new entities, the window needs to be resimulated from the last validated frame
+	_lastSimulatedFrame = _lastValidateFrame;
+	if (_speculation != nullptr)
+	{
+		_speculation->Invalidate();
+	}
+}
+
+void RollbackManager::AdvanceValidatedWorld(const Frame newValidateFrame)
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	// All the inputs are received, the frames are simulated only once and never restored
+	for (Frame frame = _lastValidateFrame + 1; frame <= newValidateFrame; frame++)
+	{
+		SimulateFrame(frame);
+	}
+
+	// The destroyed entities are not part of the checksum, it can be computed before removing them
+	_lastValidateChecksum = ComputeChecksum();
+
+	// Definitely remove DESTROY entities
+	for (const auto& [entity, destroyedFrame] : _destroyedEntities)
+	{
+		DestroyValidatedEntity(entity);
+	}
+
+	_destroyedEntities.clear();
+	_createdEntities.clear();
+
+	_lastValidateFrame = newValidateFrame;
+	_lastSimulatedFrame = newValidateFrame;
+	_currentWorldFrame = newValidateFrame;
+}
+
+void RollbackManager::MarkMispredictedFrame(const Frame frame)
+{
+	// Validated frames cannot be mispredicted
+	if (frame <= _lastValidateFrame) return;
+
+	// Only the frames already simulated with the wrong prediction count as mispredicted
+	if (_rollbackMode == RollbackMode::Client && _framePredictions[frame % _windowSize] == FramePrediction::Predicted)
+	{
+		_framePredictions[frame % _windowSize] = FramePrediction::Mispredicted;
+	}
+
+	_lastSimulatedFrame = std::min(_lastSimulatedFrame, frame - 1);
+}
+
+bool RollbackManager::SetNextFallingWallSpawnInstructions(
+	const FallingWallSpawnInstructions fallingWallSpawnInstructions)
+{
+	const bool currentResult = _currentFallingWallSpawnManager.SetNextFallingWallSpawnInstructions(
+		fallingWallSpawnInstructions);
+
+	// The current world of the server is the validated world
+	if (_rollbackMode == RollbackMode::Server) return currentResult;
+
+	// The speculative timelines were simulated with the previous instructions
+	if (_speculation != nullptr)
+	{
+		_speculation->Invalidate();
+	}
+
+	const bool lastValidateResult = SetFallingWallSpawnInstructions(_lastValidateWorld, fallingWallSpawnInstructions);
+
+	// The snapshots are restored instead of the last validated world, they need the instructions too
+	for (Frame frame = _lastValidateFrame + 1; frame <= _lastSimulatedFrame; frame++)
+	{
+		SetFallingWallSpawnInstructions(GetSnapshot(frame).header, fallingWallSpawnInstructions);
+	}
+
+	return lastValidateResult && currentResult;
+}
+
+bool RollbackManager::SetFallingWallSpawnInstructions(WorldBlob& world,
+                                                      const FallingWallSpawnInstructions fallingWallSpawnInstructions)
+{
+	std::size_t offset = 0;
+	auto header = world.Read<WorldHeader>(offset);
+	if (!SetFallingWallSpawnInstructions(header, fallingWallSpawnInstructions)) return false;
+
+	world.Overwrite(0, header);
+	return true;
+}
+
+bool RollbackManager::SetFallingWallSpawnInstructions(WorldHeader& header,
+                                                      const FallingWallSpawnInstructions fallingWallSpawnInstructions)
+{
+	if (!header.hasFallingWallSpawned) return false;
+
+	header.fallingWallSpawnInstructions = fallingWallSpawnInstructions;
+	header.hasFallingWallSpawned = false;
+	return true;
+}
+
+float RollbackManager::GetPredictionHitRatio() const
+{
+	const std::size_t total = _predictionHitCount + _predictionMissCount;
+	if (total == 0) return 1.0f;
+
+	return static_cast<float>(_predictionHitCount) / static_cast<float>(total);
 }
 
 void RollbackManager::OnTrigger(const core::Entity, const core::Entity)
@@ -533,24 +1307,26 @@ void RollbackManager::SpawnBall(const core::Entity entity, const core::Vec2f pos
 	_currentPhysicsManager.SetCircleCollider(entity, ballCircle);
 }
 
-void RollbackManager::DestroyEntity(core::Entity entity)
+void RollbackManager::DestroyValidatedEntity(const core::Entity entity)
+{
+	// The sparse set of the falling objects does not see the destroyed entities
+	if (_entityManager.HasComponent(entity, FallingObjectManager::COMPONENT_FLAG))
+	{
+		_currentFallingObjectManager.RemoveComponent(entity);
+	}
+
+	_entityManager.DestroyEntity(entity);
+}
+
+void RollbackManager::DestroyEntity(const core::Entity entity)
 {
 	#ifdef TRACY_ENABLE
 	ZoneScoped;
 	#endif
 
-	// we don't need to save a bullet that has been created in the time window
-	const auto predicate = [entity](auto newEntity)
-	{
-		return newEntity.entity == entity;
-	};
-
-	if (std::ranges::find_if(_createdEntities, predicate) != _createdEntities.end())
-	{
-		_entityManager.DestroyEntity(entity);
-		return;
-	}
+	if (_entityManager.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::Destroyed))) return;
 
 	_entityManager.AddComponent(entity, static_cast<core::EntityMask>(ComponentType::Destroyed));
+	_destroyedEntities.push_back({entity, _testedFrame});
 }
 }
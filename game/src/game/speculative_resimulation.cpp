@@ -0,0 +1,58 @@
+#include "game/speculative_resimulation.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace game
+{
+// Changes of the remote input ordered by likelihood, a single key then two keys
+constexpr std::array<PlayerInput, 15> HYPOTHESIS_INPUT_CHANGES
+{
+	player_input_enum::Up,
+	player_input_enum::Down,
+	player_input_enum::Left,
+	player_input_enum::Right,
+	player_input_enum::Shoot,
+	player_input_enum::Up | player_input_enum::Left,
+	player_input_enum::Up | player_input_enum::Right,
+	player_input_enum::Down | player_input_enum::Left,
+	player_input_enum::Down | player_input_enum::Right,
+	player_input_enum::Up | player_input_enum::Shoot,
+	player_input_enum::Down | player_input_enum::Shoot,
+	player_input_enum::Left | player_input_enum::Shoot,
+	player_input_enum::Right | player_input_enum::Shoot,
+	player_input_enum::Up | player_input_enum::Down,
+	player_input_enum::Left | player_input_enum::Right,
+};
+
+SpeculativeResimulation::SpeculativeResimulation(const std::size_t hypothesisCount, const std::size_t windowSize)
+{
+	_hypotheses.resize(std::min(hypothesisCount, HYPOTHESIS_INPUT_CHANGES.size()));
+	for (SpeculativeHypothesis& hypothesis : _hypotheses)
+	{
+		hypothesis.gameManager = std::make_unique<SpeculativeGameManager>();
+		hypothesis.gameManager->GetRollbackManager().SetWindowSize(windowSize);
+	}
+}
+
+PlayerInput SpeculativeResimulation::GetRemoteInput(const PlayerInput lastInput, const std::size_t hypothesisIndex)
+{
+	return static_cast<PlayerInput>(lastInput ^ HYPOTHESIS_INPUT_CHANGES[hypothesisIndex]);
+}
+
+void SpeculativeResimulation::Start(const Frame baseFrame, const Frame targetFrame)
+{
+	_baseFrame = baseFrame;
+	_targetFrame = targetFrame;
+	_hasResults = true;
+}
+
+bool SpeculativeResimulation::IsRunning() const
+{
+	return std::ranges::any_of(_hypotheses, [](const SpeculativeHypothesis& hypothesis)
+	{
+		return hypothesis.job.valid() &&
+			hypothesis.job.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+	});
+}
+}
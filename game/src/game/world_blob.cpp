@@ -0,0 +1,186 @@
+#include "game/world_blob.hpp"
+
+#include <algorithm>
+
+namespace game
+{
+void WorldBlob::Assign(const std::uint8_t* data, const std::size_t size)
+{
+	_size = 0;
+	WriteBytes(data, size);
+}
+
+void WorldBlob::WriteDelta(const WorldBlob& base, const std::size_t startOffset,
+                           std::vector<std::uint8_t>& delta) const
+{
+	// A run header costs 8 bytes, runs closer than that are merged
+	constexpr std::size_t mergeDistance = 2 * sizeof(std::uint32_t);
+
+	delta.clear();
+	const auto appendRun = [this, &delta](const std::size_t runStart, const std::size_t runEnd)
+	{
+		const auto runOffset = static_cast<std::uint32_t>(runStart);
+		const auto runLength = static_cast<std::uint32_t>(runEnd - runStart);
+		const std::size_t deltaSize = delta.size();
+		delta.resize(deltaSize + sizeof(runOffset) + sizeof(runLength) + runLength);
+		std::memcpy(delta.data() + deltaSize, &runOffset, sizeof(runOffset));
+		std::memcpy(delta.data() + deltaSize + sizeof(runOffset), &runLength, sizeof(runLength));
+		std::memcpy(delta.data() + deltaSize + sizeof(runOffset) + sizeof(runLength), _data.data() + runStart,
+		            runLength);
+	};
+
+	std::size_t runStart = _size;
+	std::size_t runEnd = _size;
+	for (std::size_t i = startOffset; i < _size; i++)
+	{
+		// Bytes after the end of the base are always different
+		if (i < base._size && _data[i] == base._data[i]) continue;
+
+		if (runStart != _size && i - runEnd < mergeDistance)
+		{
+			runEnd = i + 1;
+			continue;
+		}
+
+		if (runStart != _size)
+		{
+			appendRun(runStart, runEnd);
+		}
+
+		runStart = i;
+		runEnd = i + 1;
+	}
+
+	if (runStart != _size)
+	{
+		appendRun(runStart, runEnd);
+	}
+}
+
+void WorldBlob::ApplyDelta(const std::vector<std::uint8_t>& delta, const std::size_t size)
+{
+	Resize(size);
+
+	std::size_t deltaOffset = 0;
+	while (deltaOffset < delta.size())
+	{
+		std::uint32_t runOffset = 0;
+		std::uint32_t runLength = 0;
+		std::memcpy(&runOffset, delta.data() + deltaOffset, sizeof(runOffset));
+		std::memcpy(&runLength, delta.data() + deltaOffset + sizeof(runOffset), sizeof(runLength));
+		deltaOffset += sizeof(runOffset) + sizeof(runLength);
+
+		gpr_assert(runOffset + runLength <= _size, "Applying a delta outside of the WorldBlob");
+		std::memcpy(_data.data() + runOffset, delta.data() + deltaOffset, runLength);
+		deltaOffset += runLength;
+	}
+}
+
+// Runs of at least 3 equal bytes are encoded as a control byte with the high bit set followed by the byte,
+// other bytes are copied after a control byte that gives their count.
+constexpr std::size_t MIN_RUN_LENGTH = 3;
+constexpr std::size_t MAX_RUN_LENGTH = 0x7F + MIN_RUN_LENGTH;
+constexpr std::size_t MAX_LITERAL_LENGTH = 0x80;
+constexpr std::uint8_t RUN_FLAG = 0x80;
+
+void WorldBlob::Compress(std::vector<std::uint8_t>& compressed) const
+{
+	compressed.clear();
+
+	std::size_t i = 0;
+	while (i < _size)
+	{
+		std::size_t runLength = 1;
+		while (i + runLength < _size && runLength < MAX_RUN_LENGTH && _data[i + runLength] == _data[i])
+		{
+			runLength++;
+		}
+
+		if (runLength >= MIN_RUN_LENGTH)
+		{
+			compressed.push_back(static_cast<std::uint8_t>(RUN_FLAG | (runLength - MIN_RUN_LENGTH)));
+			compressed.push_back(_data[i]);
+			i += runLength;
+			continue;
+		}
+
+		// Copy the bytes as is until the next run
+		std::size_t literalEnd = i + 1;
+		while (literalEnd < _size && literalEnd - i < MAX_LITERAL_LENGTH)
+		{
+			if (literalEnd + MIN_RUN_LENGTH <= _size &&
+				_data[literalEnd] == _data[literalEnd + 1] && _data[literalEnd] == _data[literalEnd + 2])
+			{
+				break;
+			}
+
+			literalEnd++;
+		}
+
+		compressed.push_back(static_cast<std::uint8_t>(literalEnd - i - 1));
+		compressed.insert(compressed.end(), _data.begin() + static_cast<std::ptrdiff_t>(i),
+		                  _data.begin() + static_cast<std::ptrdiff_t>(literalEnd));
+		i = literalEnd;
+	}
+}
+
+bool WorldBlob::Decompress(const std::vector<std::uint8_t>& compressed, const std::size_t size)
+{
+	Resize(size);
+
+	std::size_t offset = 0;
+	std::size_t i = 0;
+	while (i < compressed.size())
+	{
+		const std::uint8_t control = compressed[i++];
+		if (control & RUN_FLAG)
+		{
+			const std::size_t runLength = (control & ~RUN_FLAG) + MIN_RUN_LENGTH;
+			if (i >= compressed.size() || offset + runLength > _size) return false;
+
+			std::memset(_data.data() + offset, compressed[i++], runLength);
+			offset += runLength;
+		}
+		else
+		{
+			const std::size_t literalLength = control + 1u;
+			if (i + literalLength > compressed.size() || offset + literalLength > _size) return false;
+
+			std::memcpy(_data.data() + offset, compressed.data() + i, literalLength);
+			i += literalLength;
+			offset += literalLength;
+		}
+	}
+
+	return offset == _size;
+}
+
+void WorldBlob::Resize(const std::size_t size)
+{
+	// The buffer is only grown, a world of the same size is saved again without allocating
+	if (_data.size() < size)
+	{
+		_data.resize(std::max(size, _data.size() * 2));
+	}
+
+	_size = size;
+}
+
+void WorldBlob::WriteBytes(const void* data, const std::size_t size)
+{
+	if (size == 0) return;
+
+	const std::size_t offset = _size;
+	Resize(_size + size);
+	std::memcpy(_data.data() + offset, data, size);
+}
+
+void WorldBlob::ReadBytes(std::size_t& offset, void* data, const std::size_t size) const
+{
+	if (size == 0) return;
+
+	gpr_assert(offset + size <= _size, "Reading outside of the WorldBlob");
+	std::memcpy(data, _data.data() + offset, size);
+	offset += size;
+}
+}
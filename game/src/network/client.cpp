@@ -57,19 +57,19 @@ void Client::ReceivePacket(const Packet* packet)
 			if (playerNumber == _gameManager.GetPlayerNumber())
 			{
 				// Verify the inputs coming back from the server
-				const auto& inputs = _gameManager.GetRollbackManager().GetInputs(playerNumber);
-				const auto currentFrame = _gameManager.GetRollbackManager().GetCurrentFrame();
+				const auto& rollbackManager = _gameManager.GetRollbackManager();
+				const auto currentFrame = rollbackManager.GetCurrentFrame();
 				for (size_t i = 0; i < playerInputPacket->inputs.size(); i++)
 				{
-					const auto index = static_cast<unsigned long long>(currentFrame) - inputFrame + i;
-					if (index > inputs.size()) break;
+					const Frame frame = inputFrame - static_cast<Frame>(i);
+					if (frame > currentFrame || currentFrame - frame >= rollbackManager.GetWindowSize()) break;
 
-					if (inputs[index] != playerInputPacket->inputs[i])
+					if (rollbackManager.GetInputAtFrame(playerNumber, frame) != playerInputPacket->inputs[i])
 					{
 						gpr_assert(false, "Inputs coming back from server are not coherent!!!");
 					}
 
-					if (inputFrame - i == 0) break;
+					if (frame == 0) break;
 				}
 				break;
 			}
@@ -80,6 +80,10 @@ void Client::ReceivePacket(const Packet* packet)
 				break;
 			}
 
+			_gameManager.UpdateFrameAdvantage(playerNumber,
+			                                  inputFrame - playerInputPacket->inputDelay,
+			                                  playerInputPacket->frameAdvantage);
+
 			for (Frame i = 0; i < playerInputPacket->inputs.size(); i++)
 			{
 				_gameManager.SetPlayerInput(playerNumber,
@@ -97,13 +101,8 @@ void Client::ReceivePacket(const Packet* packet)
 		{
 			const auto* validateFramePacket = static_cast<const ValidateFramePacket*>(packet);
 			const auto newValidateFrame = core::ConvertFromBinary<Frame>(validateFramePacket->newValidateFrame);
-			std::array<PhysicsState, MAX_PLAYER_NMB> physicsStates{};
-			for (size_t i = 0; i < validateFramePacket->physicsState.size(); i++)
-			{
-				auto* statePtr = reinterpret_cast<std::uint8_t*>(physicsStates.data());
-				statePtr[i] = validateFramePacket->physicsState[i];
-			}
-			_gameManager.ConfirmValidateFrame(newValidateFrame, physicsStates);
+			const auto worldChecksum = core::ConvertFromBinary<WorldChecksum>(validateFramePacket->worldChecksum);
+			_gameManager.ConfirmValidateFrame(newValidateFrame, worldChecksum);
 			break;
 		}
 	case PacketType::LoseGame:
@@ -143,9 +142,28 @@ void Client::ReceivePacket(const Packet* packet)
 
 				_rto = _srtt + std::max(G, K * _rttvar);
 				_currentPing = _srtt;
+				_gameManager.SetRoundTripTime(_srtt);
 			}
 			break;
 		}
+	case PacketType::ResyncWorld:
+		{
+			const auto* resyncWorldPacket = static_cast<const ResyncWorldPacket*>(packet);
+			if (resyncWorldPacket->playerNumber != _gameManager.GetPlayerNumber()) break;
+
+			WorldBlob world;
+			const auto worldSize = core::ConvertFromBinary<std::uint32_t>(resyncWorldPacket->worldSize);
+			if (!world.Decompress(resyncWorldPacket->compressedWorld, worldSize))
+			{
+				core::LogWarning("Received a corrupted resync world.");
+				break;
+			}
+
+			_gameManager.ResyncValidatedWorld(core::ConvertFromBinary<Frame>(resyncWorldPacket->validateFrame),
+			                                  world,
+			                                  core::ConvertFromBinary<WorldChecksum>(resyncWorldPacket->worldChecksum));
+			break;
+		}
 	case PacketType::SpawnFallingWall:
 		{
 			const auto* spawnFallingWallPacket = static_cast<const SpawnFallingWallPacket*>(packet);
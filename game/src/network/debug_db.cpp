@@ -73,21 +73,17 @@ void DebugDatabase::StorePacket(const PlayerInputPacket* inputPacket)
     cv_.notify_one();
 }
 
-void DebugDatabase::StorePhysicsState(const DbPhysicsState& physicsState)
+void DebugDatabase::StoreWorldChecksum(const DbWorldChecksum& worldChecksum)
 {
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
 
-    std::string query = "INSERT INTO physics_state (local_frame, validate_frame ";
-    std::string arguments;
-    std::string values = fmt::format(" VALUES ({}, {}", physicsState.lastLocalValidateFrame, physicsState.validateFrame);
-    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-    {
-        arguments += fmt::format(",state_p{}_local, state_p{}_server ", playerNumber + 1, playerNumber + 1);
-        values += fmt::format(",{},{}", physicsState.localStates[playerNumber], physicsState.serverStates[playerNumber]);
-    }
-    query += arguments + ") " + values + " );";
+    // SQLite integers are signed, the checksums are stored with the same bits
+    const std::string query = fmt::format(
+        "INSERT INTO world_checksum (local_frame, validate_frame, checksum_local, checksum_server) VALUES ({}, {}, {}, {});",
+        worldChecksum.lastLocalValidateFrame, worldChecksum.validateFrame,
+        static_cast<std::int64_t>(worldChecksum.localChecksum), static_cast<std::int64_t>(worldChecksum.serverChecksum));
     {
         std::lock_guard lock(m_);
         commands_.push_back(query);
@@ -168,18 +164,14 @@ void DebugDatabase::CreateTables() const
         sqlite3_free(zErrMsg);
     }
 
-    std::string createPhysicsStateTable = "CREATE TABLE physics_state ("\
-        "phys_id INTEGER PRIMARY KEY,"\
+    const auto* createWorldChecksumTable = "CREATE TABLE world_checksum ("\
+        "checksum_id INTEGER PRIMARY KEY,"\
         "local_frame INTEGER NOT NULL,"\
-        "validate_frame INTEGER NOT NULL"\
-        ;
-    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-    {
-        createPhysicsStateTable += fmt::format(",state_p{}_local INTEGER NOT NULL, state_p{}_server INTEGER NOT NULL", playerNumber + 1, playerNumber + 1);
-    }
-    createPhysicsStateTable += ");";
+        "validate_frame INTEGER NOT NULL,"\
+        "checksum_local INTEGER NOT NULL,"\
+        "checksum_server INTEGER NOT NULL);";
     zErrMsg = nullptr;
-    const auto rc2 = sqlite3_exec(db, createPhysicsStateTable.data(), callback, nullptr, &zErrMsg);
+    const auto rc2 = sqlite3_exec(db, createWorldChecksumTable, callback, nullptr, &zErrMsg);
     if (rc2 != SQLITE_OK) {
         core::LogError(fmt::format("SQL error while creating table: {}", zErrMsg));
         sqlite3_free(zErrMsg);
@@ -238,11 +238,7 @@ void NetworkClient::SendUnreliablePacket(const std::unique_ptr<Packet> packet)
 
 void NetworkClient::SetPlayerInput(const PlayerInput playerInput)
 {
-	const auto currentFrame = _gameManager.GetCurrentFrame();
-	_gameManager.SetPlayerInput(
-		_gameManager.GetPlayerNumber(),
-		playerInput,
-		currentFrame);
+	_gameManager.SetLocalPlayerInput(playerInput);
 }
 
 void NetworkClient::ReceivePacket(const Packet* packet)
@@ -264,19 +260,12 @@ void NetworkClient::ReceivePacket(const Packet* packet)
 	{
 		auto* validateStatePacket = static_cast<const ValidateFramePacket*>(packet);
 		const auto newValidateFrame = core::ConvertFromBinary<Frame>(validateStatePacket->newValidateFrame);
-		DbPhysicsState state{};
+		DbWorldChecksum state{};
 		state.validateFrame = newValidateFrame;
 		state.lastLocalValidateFrame = gameManager_.GetLastValidateFrame();
-		for (size_t i = 0; i < validateStatePacket->physicsState.size(); i++)
-		{
-			auto* statePtr = reinterpret_cast<std::uint8_t*>(state.serverStates.data());
-			statePtr[i] = validateStatePacket->physicsState[i];
-		}
-		for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-		{
-			state.localStates[playerNumber] = gameManager_.GetRollbackManager().GetValidatePhysicsState(playerNumber);
-		}
-		debugDb_.StorePhysicsState(state);
+		state.serverChecksum = core::ConvertFromBinary<WorldChecksum>(validateStatePacket->worldChecksum);
+		state.localChecksum = gameManager_.GetRollbackManager().GetValidateChecksum();
+		debugDb_.StoreWorldChecksum(state);
 		break;
 	}
 	case PacketType::START_GAME: break;
@@ -329,6 +318,8 @@ void NetworkClient::ReceiveNetPacket(sf::Packet& packet, const PacketSource sour
 	case PacketType::StartGame:
 	case PacketType::LoseGame:
 	case PacketType::Ping:
+	case PacketType::ResyncRequest:
+	case PacketType::ResyncWorld:
 	case PacketType::None:
 	default:
 		break;
@@ -145,16 +145,8 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
 				auto validateFramePacket = std::make_unique<ValidateFramePacket>();
 				validateFramePacket->newValidateFrame = core::ConvertToBinary(lastReceiveFrame);
 
-				// copy physics state
-				for (PlayerNumber i = 0; i < MAX_PLAYER_NMB; i++)
-				{
-					auto physicsState = _gameManager.GetRollbackManager().GetValidatePhysicsState(i);
-					const auto* statePtr = reinterpret_cast<const std::uint8_t*>(&physicsState);
-					for (size_t j = 0; j < sizeof(PhysicsState); j++)
-					{
-						validateFramePacket->physicsState[i * sizeof(PhysicsState) + j] = statePtr[j];
-					}
-				}
+				validateFramePacket->worldChecksum = core::ConvertToBinary(
+					_gameManager.GetRollbackManager().GetValidateChecksum());
 
 				SendUnreliablePacket(std::move(validateFramePacket));
 
@@ -184,6 +176,27 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
 			SendUnreliablePacket(std::move(pingPacket));
 			break;
 		}
+	case PacketType::ResyncRequest:
+		{
+			const auto* resyncRequestPacket = dynamic_cast<const ResyncRequestPacket*>(packet.get());
+			const auto& rollbackManager = _gameManager.GetRollbackManager();
+			core::LogInfo(fmt::format("[Server] Player {} desynced at frame {}, sending the world of frame {}",
+			                          resyncRequestPacket->playerNumber + 1,
+			                          core::ConvertFromBinary<Frame>(resyncRequestPacket->mismatchFrame),
+			                          rollbackManager.GetLastValidateFrame()));
+
+			WorldBlob world;
+			rollbackManager.WriteValidatedWorld(world);
+
+			auto resyncWorldPacket = std::make_unique<ResyncWorldPacket>();
+			resyncWorldPacket->playerNumber = resyncRequestPacket->playerNumber;
+			resyncWorldPacket->validateFrame = core::ConvertToBinary(rollbackManager.GetLastValidateFrame());
+			resyncWorldPacket->worldChecksum = core::ConvertToBinary(rollbackManager.GetValidateChecksum());
+			resyncWorldPacket->worldSize = core::ConvertToBinary(static_cast<std::uint32_t>(world.GetSize()));
+			world.Compress(resyncWorldPacket->compressedWorld);
+			SendReliablePacket(std::move(resyncWorldPacket));
+			break;
+		}
 	default:
 		break;
 	}
@@ -66,8 +66,7 @@ void SimulationClient::Draw(sf::RenderTarget& renderTarget)
 
 void SimulationClient::SetPlayerInput(const PlayerInput playerInput)
 {
-	const auto currentFrame = _gameManager.GetCurrentFrame();
-	_gameManager.SetPlayerInput(_gameManager.GetPlayerNumber(), playerInput, currentFrame);
+	_gameManager.SetLocalPlayerInput(playerInput);
 }
 
 void SimulationClient::DrawImGui()
@@ -125,19 +124,12 @@ void SimulationClient::ReceivePacket(const Packet* packet)
 	{
 		auto* validateStatePacket = static_cast<const ValidateFramePacket*>(packet);
 		const auto newValidateFrame = core::ConvertFromBinary<Frame>(validateStatePacket->newValidateFrame);
-		DbPhysicsState state{};
+		DbWorldChecksum state{};
 		state.validateFrame = newValidateFrame;
 		state.lastLocalValidateFrame = gameManager_.GetLastValidateFrame();
-		for (size_t i = 0; i < validateStatePacket->physicsState.size(); i++)
-		{
-			auto* statePtr = reinterpret_cast<std::uint8_t*>(state.serverStates.data());
-			statePtr[i] = validateStatePacket->physicsState[i];
-		}
-		for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-		{
-			state.localStates[playerNumber] = gameManager_.GetRollbackManager().GetValidatePhysicsState(playerNumber);
-		}
-		debugDb_.StorePhysicsState(state);
+		state.serverChecksum = core::ConvertFromBinary<WorldChecksum>(validateStatePacket->worldChecksum);
+		state.localChecksum = gameManager_.GetRollbackManager().GetValidateChecksum();
+		debugDb_.StoreWorldChecksum(state);
 		break;
 	}
 	case PacketType::START_GAME: break;
@@ -0,0 +1,28 @@
+#include "physics/broad_phase.hpp"
+
+#include "game/game_globals.hpp"
+
+namespace game
+{
+void BroadPhase::UnpackPairs(const std::span<const std::uint64_t> pairKeys, const core::EntityManager& entityManager,
+                             std::vector<std::pair<core::Entity, core::Entity>>& collisionPairs)
+{
+	collisionPairs.clear();
+	for (const std::uint64_t pairKey : pairKeys)
+	{
+		const auto entityA = static_cast<core::Entity>(pairKey >> 32u);
+		const auto entityB = static_cast<core::Entity>(pairKey);
+
+		const bool aIsDestroyed = entityManager.HasComponent(entityA,
+		                                                     static_cast<core::EntityMask>(
+			                                                     ComponentType::Destroyed));
+		const bool bIsDestroyed = entityManager.HasComponent(entityB,
+		                                                     static_cast<core::EntityMask>(
+			                                                     ComponentType::Destroyed));
+
+		if (aIsDestroyed || bIsDestroyed) continue;
+
+		collisionPairs.emplace_back(entityA, entityB);
+	}
+}
+}
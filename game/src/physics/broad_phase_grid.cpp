@@ -1,6 +1,9 @@
 #include "physics/broad_phase_grid.hpp"
 
 #include <algorithm>
+#include <bit>
+#include <span>
+#include <utility>
 
 #include "engine/component.hpp"
 
@@ -8,6 +11,10 @@
 
 #include "physics/physics_manager.hpp"
 
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
 namespace game
 {
 BroadPhaseGrid::BroadPhaseGrid(
@@ -24,16 +31,27 @@ BroadPhaseGrid::BroadPhaseGrid(
 		  std::floor((_max.x - _min.x) / _cellSize))),
 	  _gridHeight(static_cast<std::size_t>(
 		  std::floor((_max.y - _min.y) / _cellSize))),
+	  _cellCount(_gridWidth * _gridHeight),
 	  _entityManager(entityManager), _rigidbodyManager(rigidbodyManager),
 	  _aabbManager(aabbManager), _circleManager(circleManager)
 {
+	// The grid is allocated once, Update only overwrites it
+	_cellStarts.resize(_cellCount + 1, 0);
+	_cellCursors.resize(_cellCount, 0);
+	_occupiedCells.resize((_cellCount + 63) / 64, 0);
 }
 
 void BroadPhaseGrid::Update()
 {
-	_grid.clear();
-	_grid.resize(_gridWidth);
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	_bodies.clear();
+	std::fill(_cellStarts.begin(), _cellStarts.end(), 0);
+	std::fill(_occupiedCells.begin(), _occupiedCells.end(), 0);
 
+	// First pass, the cells of every body are counted
 	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
 	{
 		const bool isRigidbody = _entityManager.HasComponent(entity,
@@ -41,11 +59,9 @@ void BroadPhaseGrid::Update()
 			                                                     core::ComponentType::Rigidbody));
 		if (!isRigidbody) continue;
 
-		Rigidbody& body = _rigidbodyManager.GetComponent(entity);
+		const Transform& transform = std::as_const(_rigidbodyManager).GetTransform(entity);
 
-		const auto& transform = body.Trans();
-
-		const Collider* collider = PhysicsManager::GetCollider(_entityManager, _aabbManager, _circleManager, entity);
+		const ColliderPtr collider = PhysicsManager::GetCollider(_entityManager, _aabbManager, _circleManager, entity);
 
 		if (!collider) continue;
 
@@ -58,7 +74,7 @@ void BroadPhaseGrid::Update()
 			continue;
 		}
 
-		const core::Vec2f boundingBoxSize = collider->GetBoundingBoxSize();
+		const core::Vec2f boundingBoxSize = collider.GetBoundingBoxSize();
 
 		int xBodyMin = static_cast<int>(std::floor((offsetCenter.x - boundingBoxSize.x - _min.x) / _cellSize));
 		xBodyMin = std::clamp(xBodyMin, 0, static_cast<int>(_gridWidth));
@@ -69,83 +85,75 @@ void BroadPhaseGrid::Update()
 		int yBodyMax = static_cast<int>(std::floor((offsetCenter.y + boundingBoxSize.y - _min.y) / _cellSize));
 		yBodyMax = std::clamp(yBodyMax, 0, static_cast<int>(_gridHeight) - 1);
 
-		for (int x = xBodyMin; x <= xBodyMax; x++)
+		const BodyCells& body = _bodies.emplace_back(BodyCells{entity, xBodyMin, yBodyMin, xBodyMax, yBodyMax});
+		for (int x = body.xMin; x <= body.xMax; x++)
 		{
-			if (_grid[x].empty()) _grid[x].resize(_gridHeight);
+			for (int y = body.yMin; y <= body.yMax; y++)
+			{
+				const std::size_t cell = GetCellIndex(x, y);
+				// The count of a cell is stored after its start, so the prefix sum gives the starts directly
+				_cellStarts[cell + 1]++;
+				_occupiedCells[cell / 64] |= std::uint64_t{1} << (cell % 64);
+			}
+		}
+	}
 
-			std::vector<std::vector<core::Entity>>& gridCol = _grid[x];
+	// Prefix sum of the counts, a cell spans from its start to the start of the next one
+	for (std::size_t cell = 0; cell < _cellCount; cell++)
+	{
+		_cellStarts[cell + 1] += _cellStarts[cell];
+	}
 
-			// Loop through each cell
-			for (int y = yBodyMin; y <= yBodyMax; y++)
+	// Second pass, the bodies are scattered in their cells, in increasing Entity order
+	_cellEntities.resize(_cellStarts[_cellCount]);
+	std::copy(_cellStarts.begin(), _cellStarts.end() - 1, _cellCursors.begin());
+	for (const BodyCells& body : _bodies)
+	{
+		for (int x = body.xMin; x <= body.xMax; x++)
+		{
+			for (int y = body.yMin; y <= body.yMax; y++)
 			{
-				std::vector<core::Entity>& gridCell = gridCol[y];
-				gridCell.push_back(entity);
+				_cellEntities[_cellCursors[GetCellIndex(x, y)]++] = body.entity;
 			}
 		}
 	}
 }
 
-std::vector<std::pair<core::Entity, core::Entity>> BroadPhaseGrid::GetCollisionPairs() const
+void BroadPhaseGrid::GetCollisionPairs(std::vector<std::pair<core::Entity, core::Entity>>& collisionPairs)
 {
-	std::unordered_multimap<core::Entity, core::Entity> checkedCollisions;
-	std::vector<std::pair<core::Entity, core::Entity>> collisions;
-	collisions.reserve(64);
-
-	for (auto& gridCol : _grid)
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	// Every pair of a cell is packed in a key, the lower Entity in the high bits
+	_pairKeys.clear();
+	// Only the occupied cells are visited, in increasing cell order
+	for (std::size_t word = 0; word < _occupiedCells.size(); word++)
 	{
-		for (auto& gridCell : gridCol)
+		std::uint64_t occupiedBits = _occupiedCells[word];
+		while (occupiedBits != 0)
 		{
+			const std::size_t cell = word * 64 + std::countr_zero(occupiedBits);
+			occupiedBits &= occupiedBits - 1;
+
+			const std::span<const core::Entity> gridCell(
+				_cellEntities.data() + _cellStarts[cell], _cellStarts[cell + 1] - _cellStarts[cell]);
 			for (std::size_t i = 0; i < gridCell.size(); ++i)
 			{
-				core::Entity entityA = gridCell[i];
+				const core::Entity entityA = gridCell[i];
 				for (std::size_t j = i + 1; j < gridCell.size(); ++j)
 				{
-					core::Entity entityB = gridCell[j];
-
-					std::pair<core::Entity, core::Entity> bodyPair = entityA < entityB
-						                                                 ? std::make_pair(entityA, entityB)
-						                                                 : std::make_pair(entityB, entityA);
-
-					if (HasBeenChecked(checkedCollisions, bodyPair)) continue;
-
-					checkedCollisions.insert(bodyPair);
-
-					const bool aIsDestroyed = _entityManager.HasComponent(entityA,
-					                                                      static_cast<core::EntityMask>(
-						                                                      ComponentType::Destroyed));
-					const bool bIsDestroyed = _entityManager.HasComponent(entityB,
-					                                                      static_cast<core::EntityMask>(
-						                                                      ComponentType::Destroyed));
-
-					if (aIsDestroyed || bIsDestroyed) continue;
-
-
-					collisions.emplace_back(bodyPair.first, bodyPair.second);
+					const core::Entity entityB = gridCell[j];
+					_pairKeys.push_back(PackPair(std::min(entityA, entityB), std::max(entityA, entityB)));
 				}
 			}
 		}
 	}
 
-	return collisions;
-}
-
-bool BroadPhaseGrid::HasBeenChecked(
-	const std::unordered_multimap<core::Entity, core::Entity>& checkedCollisions,
-	const std::pair<core::Entity, core::Entity>& bodyPair
-)
-{
-	auto [first, second] =
-		checkedCollisions.equal_range(bodyPair.first);
-	bool isContained = false;
-	for (auto& i = first; i != second; ++i)
-	{
-		if (i->second == bodyPair.second)
-		{
-			isContained = true;
-			break;
-		}
-	}
+	// The bodies spanning several cells give the same pair more than once
+	std::sort(_pairKeys.begin(), _pairKeys.end());
+	const auto uniqueEnd = std::unique(_pairKeys.begin(), _pairKeys.end());
 
-	return isContained;
+	UnpackPairs({_pairKeys.begin(), uniqueEnd}, _entityManager, collisionPairs);
 }
 }
@@ -10,12 +10,6 @@ namespace game
 {
 #pragma region CircleCollider
 
-Manifold CircleCollider::TestCollision(const Transform* transform, const Collider* collider,
-                                       const Transform* colliderTransform) const
-{
-	return collider->TestCollision(colliderTransform, this, transform).Swaped();
-}
-
 Manifold CircleCollider::TestCollision(const Transform* transform, const CircleCollider* collider,
                                        const Transform* circleTransform) const
 {
@@ -40,12 +34,6 @@ core::Vec2f CircleCollider::GetBoundingBoxSize() const
 #pragma endregion
 
 #pragma region AabbCollider
-Manifold AabbCollider::TestCollision(const Transform* transform, const Collider* collider,
-                                     const Transform* colliderTransform) const
-{
-	return collider->TestCollision(colliderTransform, this, transform).Swaped();
-}
-
 Manifold AabbCollider::TestCollision(const Transform* transform, const CircleCollider* collider,
                                      const Transform* circleTransform) const
 {
@@ -68,4 +56,64 @@ core::Vec2f AabbCollider::GetBoundingBoxSize() const
 	return {halfWidth * 2.0f, halfHeight * 2.0f};
 }
 #pragma endregion
+
+#pragma region ColliderPtr
+Manifold ColliderPtr::TestCollision(const Transform* transform, const ColliderPtr collider,
+                                    const Transform* colliderTransform) const
+{
+	// The other collider tests against this one, then the manifold is swapped back
+	switch (_type)
+	{
+	case core::ComponentType::CircleCollider:
+		return collider.TestCollision(colliderTransform, static_cast<const CircleCollider*>(_collider), transform).
+			Swaped();
+	case core::ComponentType::AabbCollider:
+		return collider.TestCollision(colliderTransform, static_cast<const AabbCollider*>(_collider), transform).
+			Swaped();
+	default:
+		return {};
+	}
+}
+
+Manifold ColliderPtr::TestCollision(const Transform* transform, const CircleCollider* collider,
+                                    const Transform* circleTransform) const
+{
+	switch (_type)
+	{
+	case core::ComponentType::CircleCollider:
+		return static_cast<const CircleCollider*>(_collider)->TestCollision(transform, collider, circleTransform);
+	case core::ComponentType::AabbCollider:
+		return static_cast<const AabbCollider*>(_collider)->TestCollision(transform, collider, circleTransform);
+	default:
+		return {};
+	}
+}
+
+Manifold ColliderPtr::TestCollision(const Transform* transform, const AabbCollider* collider,
+                                    const Transform* aabbTransform) const
+{
+	switch (_type)
+	{
+	case core::ComponentType::CircleCollider:
+		return static_cast<const CircleCollider*>(_collider)->TestCollision(transform, collider, aabbTransform);
+	case core::ComponentType::AabbCollider:
+		return static_cast<const AabbCollider*>(_collider)->TestCollision(transform, collider, aabbTransform);
+	default:
+		return {};
+	}
+}
+
+core::Vec2f ColliderPtr::GetBoundingBoxSize() const
+{
+	switch (_type)
+	{
+	case core::ComponentType::CircleCollider:
+		return static_cast<const CircleCollider*>(_collider)->GetBoundingBoxSize();
+	case core::ComponentType::AabbCollider:
+		return static_cast<const AabbCollider*>(_collider)->GetBoundingBoxSize();
+	default:
+		return {};
+	}
+}
+#pragma endregion
 }
@@ -1,12 +1,18 @@
 #include "physics/physics_manager.hpp"
 
+#include <algorithm>
+#include <utility>
+
 #include <SFML/Graphics/CircleShape.hpp>
 #include <SFML/Graphics/RectangleShape.hpp>
 
 #include "engine/transform.hpp"
+#include "engine/view.hpp"
 
 #include "game/game_globals.hpp"
 
+#include "utils/assert.hpp"
+
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
 #endif
@@ -19,7 +25,9 @@ PhysicsManager::PhysicsManager(core::EntityManager& entityManager)
 	  _aabbManager(entityManager),
 	  _circleManager(entityManager), _impulseSolver(_entityManager, _rigidbodyManager),
 	  _smoothPositionSolver(_entityManager, _rigidbodyManager),
-	  _grid(-500, 500, -500, 500, 10, _entityManager, _rigidbodyManager, _aabbManager, _circleManager)
+	  _grid(-500, 500, -500, 500, 10, _entityManager, _rigidbodyManager, _aabbManager, _circleManager),
+	  _sweepAndPrune(_entityManager, _rigidbodyManager, _aabbManager, _circleManager),
+	  _solverIterations(PHYSICS_SOLVER_ITERATIONS)
 {
 	_layerCollisionMatrix.SetCollision(Layer::Ball, Layer::MiddleWall, false);
 	_layerCollisionMatrix.SetCollision(Layer::Wall, Layer::Wall, false);
@@ -48,27 +56,23 @@ std::optional<core::ComponentType> PhysicsManager::HasCollider(const core::Entit
 
 void PhysicsManager::MoveBodies(const sf::Time deltaTime)
 {
-	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
-	{
-		const bool hasRigidbody = _entityManager.HasComponent(entity,
-		                                                      static_cast<core::EntityMask>(
-			                                                      core::ComponentType::Rigidbody));
-
-		if (!hasRigidbody) continue;
-
-		Rigidbody& rigidbody = GetRigidbody(entity);
+	core::View(_entityManager).With(RigidbodyManager::COMPONENT_FLAG).ForEach(
+		[this, deltaTime](const core::Entity entity)
+		{
+			const RigidbodyProperties& properties = _rigidbodyManager.GetProperties(entity);
+			if (properties.IsStatic()) return;
 
-		if (rigidbody.IsStatic()) continue;
+			core::Vec2f& velocity = _rigidbodyManager.GetVelocity(entity);
+			core::Vec2f& force = _rigidbodyManager.GetForce(entity);
 
-		const auto draggedVel = rigidbody.Velocity() * rigidbody.DragFactor();
-		const core::Vec2f vel = draggedVel + rigidbody.Force() * rigidbody.InvMass() * deltaTime.asSeconds();
-		rigidbody.SetVelocity(vel);
+			const auto draggedVel = velocity * properties.dragFactor;
+			velocity = draggedVel + force * properties.invMass * deltaTime.asSeconds();
 
-		core::Vec2f pos = rigidbody.Position() + rigidbody.Velocity() * deltaTime.asSeconds();
-		rigidbody.SetPosition(pos);
+			Transform& transform = _rigidbodyManager.GetTransform(entity);
+			transform.position = transform.position + velocity * deltaTime.asSeconds();
 
-		rigidbody.SetForce({0, 0});
-	}
+			force = {0, 0};
+		});
 }
 
 void PhysicsManager::FixedUpdate(const sf::Time deltaTime)
@@ -91,12 +95,7 @@ void PhysicsManager::SetRigidbody(const core::Entity entity, Rigidbody& body)
 	_rigidbodyManager.SetComponent(entity, body);
 }
 
-const Rigidbody& PhysicsManager::GetRigidbody(const core::Entity entity) const
-{
-	return _rigidbodyManager.GetComponent(entity);
-}
-
-Rigidbody& PhysicsManager::GetRigidbody(const core::Entity entity)
+Rigidbody PhysicsManager::GetRigidbody(const core::Entity entity) const
 {
 	return _rigidbodyManager.GetComponent(entity);
 }
@@ -104,13 +103,29 @@ Rigidbody& PhysicsManager::GetRigidbody(const core::Entity entity)
 void PhysicsManager::AddRigidbody(const core::Entity entity)
 {
 	_rigidbodyManager.AddComponent(entity);
-	Rigidbody& rb = _rigidbodyManager.GetComponent(entity);
+	Rigidbody rb = _rigidbodyManager.GetComponent(entity);
 	if (rb.TakesGravity())
 	{
 		rb.SetGravityAcceleration(_gravity);
+		_rigidbodyManager.SetComponent(entity, rb);
 	}
 }
 
+Transform& PhysicsManager::GetTransform(const core::Entity entity)
+{
+	return _rigidbodyManager.GetTransform(entity);
+}
+
+const core::Vec2f& PhysicsManager::GetVelocity(const core::Entity entity) const
+{
+	return _rigidbodyManager.GetVelocity(entity);
+}
+
+void PhysicsManager::ApplyForce(const core::Entity entity, const core::Vec2f& addedForce)
+{
+	_rigidbodyManager.GetForce(entity) += addedForce;
+}
+
 void PhysicsManager::AddAabbCollider(const core::Entity entity)
 {
 	_aabbManager.AddComponent(entity);
@@ -159,11 +174,18 @@ void PhysicsManager::RegisterCollisionListener(OnCollisionInterface& onCollision
 		});
 }
 
-void PhysicsManager::CopyAllComponents(const PhysicsManager& physicsManager)
+void PhysicsManager::SetDirtyTracking(const bool isTracking)
+{
+	_rigidbodyManager.SetDirtyTracking(isTracking);
+	_aabbManager.SetDirtyTracking(isTracking);
+	_circleManager.SetDirtyTracking(isTracking);
+}
+
+void PhysicsManager::ClearDirty()
 {
-	_rigidbodyManager.CopyAllComponents(physicsManager._rigidbodyManager.GetAllComponents());
-	_aabbManager.CopyAllComponents(physicsManager._aabbManager.GetAllComponents());
-	_circleManager.CopyAllComponents(physicsManager._circleManager.GetAllComponents());
+	_rigidbodyManager.ClearDirty();
+	_aabbManager.ClearDirty();
+	_circleManager.ClearDirty();
 }
 
 void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
@@ -185,8 +207,8 @@ void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
 
 		if (!hasRigidbody || isDestroyed || !hasCollider) continue;
 
-		const Rigidbody& rigidbody = _rigidbodyManager.GetComponent(entity);
-		const auto& position = rigidbody.Position();
+		const Transform& transform = std::as_const(_rigidbodyManager).GetTransform(entity);
+		const auto& position = transform.position;
 
 		if (hasAabbCollider)
 		{
@@ -195,7 +217,7 @@ void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
 			rectShape.setFillColor(core::Color::Transparent());
 			rectShape.setOutlineColor(core::Color::Green());
 			rectShape.setOutlineThickness(2.0f);
-			rectShape.setScale(rigidbody.Trans().scale);
+			rectShape.setScale(transform.scale);
 
 			rectShape.setOrigin({
 				aabbCollider.halfWidth * core::PIXEL_PER_METER, aabbCollider.halfHeight * core::PIXEL_PER_METER
@@ -218,7 +240,7 @@ void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
 			circleShape.setFillColor(core::Color::Transparent());
 			circleShape.setOutlineColor(core::Color::Green());
 			circleShape.setOutlineThickness(2.0f);
-			circleShape.setScale(rigidbody.Trans().scale);
+			circleShape.setScale(transform.scale);
 			circleShape.setOrigin({
 				circleCollider.radius * core::PIXEL_PER_METER, circleCollider.radius * core::PIXEL_PER_METER
 			});
@@ -234,39 +256,32 @@ void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
 
 void PhysicsManager::ApplyGravity()
 {
-	for (core::Entity entity = 0; entity < _entityManager.GetEntitiesSize(); entity++)
+	core::View(_entityManager).With(RigidbodyManager::COMPONENT_FLAG).ForEach([this](const core::Entity entity)
 	{
-		const bool hasRigidbody = _entityManager.HasComponent(entity,
-		                                                      static_cast<core::EntityMask>(
-			                                                      core::ComponentType::Rigidbody));
-
-		if (!hasRigidbody) continue;
+		const RigidbodyProperties& properties = _rigidbodyManager.GetProperties(entity);
+		if (!properties.IsDynamic()) return;
+		if (properties.invMass == 0.0f) return;
 
-		Rigidbody& rigidbody = GetRigidbody(entity);
-
-		if (!rigidbody.IsDynamic()) continue;
-		if (rigidbody.InvMass() == 0.0f) continue;
-
-		const core::Vec2f force = rigidbody.GravityAcceleration() * rigidbody.Mass();
-		rigidbody.ApplyForce(force);
-		_rigidbodyManager.SetComponent(entity, rigidbody);
-	}
+		const core::Vec2f force = properties.gravityAcceleration * (1.0f / properties.invMass);
+		_rigidbodyManager.GetForce(entity) += force;
+	});
 }
 
 void PhysicsManager::ResolveCollisions(const sf::Time deltaTime)
 {
-	// Vector for the collisions that have been detected
-	std::vector<Collision> collisions;
-	collisions.reserve(64);
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
 
-	// Vector for the collisions that have been caused by trigger colliders
-	std::vector<Collision> triggers;
-	triggers.reserve(64);
+	// Broad phase
+	_broadPhase->Update();
+	_broadPhase->GetCollisionPairs(_collisionPairs);
 
-	_grid.Update();
-	const auto collisionPairs = _grid.GetCollisionPairs();
+	// Narrow phase, the contacts of every pair are gathered before being solved
+	_collisions.clear();
+	_triggers.clear();
 
-	for (auto& [firstEntity, secondEntity] : collisionPairs)
+	for (const auto& [firstEntity, secondEntity] : _collisionPairs)
 	{
 		const bool firstHasRigidbody = _entityManager.HasComponent(firstEntity,
 		                                                           static_cast<core::EntityMask>(
@@ -275,58 +290,83 @@ void PhysicsManager::ResolveCollisions(const sf::Time deltaTime)
 		                                                            static_cast<core::EntityMask>(
 			                                                            core::ComponentType::Rigidbody));
 
-		const Collider* firstCollider = GetCollider(firstEntity);
-		const Collider* secondCollider = GetCollider(secondEntity);
+		const ColliderPtr firstCollider = GetCollider(firstEntity);
+		const ColliderPtr secondCollider = GetCollider(secondEntity);
 
 		const bool hasColliders = firstCollider && secondCollider;
 		const bool hasRigidbodies = firstHasRigidbody && secondHasRigidbody;
 
 		if (!hasColliders || !hasRigidbodies) continue;
 
-		Rigidbody& firstRigidbody = GetRigidbody(firstEntity);
-		Rigidbody& secondRigidbody = GetRigidbody(secondEntity);
+		const RigidbodyProperties& firstProperties = _rigidbodyManager.GetProperties(firstEntity);
+		const RigidbodyProperties& secondProperties = _rigidbodyManager.GetProperties(secondEntity);
 
-		const Layer firstLayer = firstRigidbody.GetLayer();
-		const Layer secondLayer = secondRigidbody.GetLayer();
+		const Layer firstLayer = firstProperties.layer;
+		const Layer secondLayer = secondProperties.layer;
 
 		if (!_layerCollisionMatrix.HasCollision(firstLayer, secondLayer)) continue;
 
-		const Manifold manifold = firstCollider->TestCollision(
-			&firstRigidbody.Trans(),
+		const Manifold manifold = firstCollider.TestCollision(
+			&std::as_const(_rigidbodyManager).GetTransform(firstEntity),
 			secondCollider,
-			&secondRigidbody.Trans()
+			&std::as_const(_rigidbodyManager).GetTransform(secondEntity)
 		);
 
 		if (!manifold.hasCollision) continue;
 
-		if (firstRigidbody.IsTrigger() || secondRigidbody.IsTrigger())
+		if (firstProperties.isTrigger || secondProperties.isTrigger)
 		{
-			triggers.emplace_back(firstEntity, secondEntity, manifold);
+			_triggers.emplace_back(firstEntity, secondEntity, manifold);
 		}
 		else
 		{
-			collisions.emplace_back(firstEntity, secondEntity, manifold);
+			_collisions.emplace_back(firstEntity, secondEntity, manifold);
 		}
+	}
 
-		SolveCollisions(collisions, deltaTime);
+	SolveCollisions(_collisions, deltaTime);
 
-		SendCollisionCallbacks(triggers, _onTriggerAction);
-		SendCollisionCallbacks(collisions, _onCollisionAction);
-	}
+	// The pairs of the broad phase are unique, each contact sends its callback once
+	SendCollisionCallbacks(_triggers, _onTriggerAction);
+	SendCollisionCallbacks(_collisions, _onCollisionAction);
 }
 
 void PhysicsManager::SolveCollisions(const std::vector<Collision>& collisions, const sf::Time deltaTime)
 {
-	_impulseSolver.Solve(collisions, deltaTime.asSeconds());
+	for (std::size_t iteration = 0; iteration < _solverIterations; iteration++)
+	{
+		_impulseSolver.Solve(collisions, deltaTime.asSeconds());
+	}
 	_smoothPositionSolver.Solve(collisions, deltaTime.asSeconds());
 }
 
-Collider* PhysicsManager::GetCollider(const core::EntityManager& entityManager, AabbColliderManager& aabbManager,
-                                      CircleColliderManager& circleManager, const core::Entity entity)
+void PhysicsManager::SetBroadPhaseType(const BroadPhaseType broadPhaseType)
+{
+	_broadPhaseType = broadPhaseType;
+	switch (broadPhaseType)
+	{
+	case BroadPhaseType::Grid:
+		_broadPhase = &_grid;
+		break;
+	case BroadPhaseType::SweepAndPrune:
+		_broadPhase = &_sweepAndPrune;
+		break;
+	}
+}
+
+void PhysicsManager::SetSolverIterations(const std::size_t solverIterations)
+{
+	gpr_assert(solverIterations > 0, "The contacts need to be solved at least once");
+	_solverIterations = std::max<std::size_t>(solverIterations, 1);
+}
+
+ColliderPtr PhysicsManager::GetCollider(const core::EntityManager& entityManager,
+                                         const AabbColliderManager& aabbManager,
+                                         const CircleColliderManager& circleManager, const core::Entity entity)
 {
 	const std::optional<core::ComponentType> colliderType = HasCollider(entityManager, entity);
 
-	if (!colliderType.has_value()) return nullptr;
+	if (!colliderType.has_value()) return {};
 
 	if (*colliderType == core::ComponentType::AabbCollider)
 	{
@@ -338,10 +378,10 @@ Collider* PhysicsManager::GetCollider(const core::EntityManager& entityManager,
 		return &circleManager.GetComponent(entity);
 	}
 
-	return nullptr;
+	return {};
 }
 
-Collider* PhysicsManager::GetCollider(const core::Entity entity)
+ColliderPtr PhysicsManager::GetCollider(const core::Entity entity) const
 {
 	return GetCollider(_entityManager, _aabbManager, _circleManager, entity);
 }
@@ -4,12 +4,13 @@
 
 namespace game
 {
-Rigidbody::Rigidbody()
-	: _invMass(1),
-	  _takesGravity(true)
+Rigidbody::Rigidbody(const Transform& transform, const core::Vec2f& velocity, const core::Vec2f& force,
+                     const RigidbodyProperties& properties)
+	: _transform(transform),
+	  _velocity(velocity),
+	  _force(force),
+	  _properties(properties)
 {
-	//static std::uint64_t staticId = 0;
-	//id = staticId++;
 }
 
 Transform& Rigidbody::Trans()
@@ -29,12 +30,12 @@ void Rigidbody::SetTransform(const Transform& transform)
 
 bool Rigidbody::IsTrigger() const
 {
-	return _isTrigger;
+	return _properties.isTrigger;
 }
 
 void Rigidbody::SetIsTrigger(const bool isTrigger)
 {
-	_isTrigger = isTrigger;
+	_properties.isTrigger = isTrigger;
 }
 
 const core::Vec2f& Rigidbody::Position() const
@@ -59,14 +60,14 @@ void Rigidbody::SetRotation(const core::Radian rotation)
 
 const core::Vec2f& Rigidbody::GravityAcceleration() const
 {
-	return _gravityAcceleration;
+	return _properties.gravityAcceleration;
 }
 
 void Rigidbody::SetGravityAcceleration(const core::Vec2f& gravityAcceleration)
 {
 	if (!TakesGravity()) return;
 
-	_gravityAcceleration = gravityAcceleration;
+	_properties.gravityAcceleration = gravityAcceleration;
 }
 
 const core::Vec2f& Rigidbody::Force() const
@@ -96,37 +97,37 @@ void Rigidbody::SetVelocity(const core::Vec2f& velocity)
 
 float Rigidbody::Mass() const
 {
-	return 1.0f / _invMass;
+	return 1.0f / _properties.invMass;
 }
 
 float Rigidbody::InvMass() const
 {
-	return _invMass;
+	return _properties.invMass;
 }
 
 void Rigidbody::SetMass(const float mass)
 {
 	if (core::Equal(mass, 0))
 	{
-		_invMass = 0;
+		_properties.invMass = 0;
 	}
-	_invMass = 1.0f / mass;
+	_properties.invMass = 1.0f / mass;
 
-	if (std::fpclassify(_invMass) == FP_SUBNORMAL)
+	if (std::fpclassify(_properties.invMass) == FP_SUBNORMAL)
 	{
-		_invMass = std::numeric_limits<float>::min();
+		_properties.invMass = std::numeric_limits<float>::min();
 	}
 }
 
 bool Rigidbody::TakesGravity() const
 {
-	return _takesGravity;
+	return _properties.takesGravity;
 }
 
 void Rigidbody::SetTakesGravity(const bool takesGravity)
 {
-	_takesGravity = takesGravity;
-	if (!_takesGravity)
+	_properties.takesGravity = takesGravity;
+	if (!_properties.takesGravity)
 	{
 		SetGravityAcceleration(core::Vec2f(0, 0));
 	}
@@ -134,31 +135,85 @@ void Rigidbody::SetTakesGravity(const bool takesGravity)
 
 float Rigidbody::StaticFriction() const
 {
-	return _staticFriction;
+	return _properties.staticFriction;
 }
 
 void Rigidbody::SetStaticFriction(const float staticFriction)
 {
-	_staticFriction = staticFriction;
+	_properties.staticFriction = staticFriction;
 }
 
 float Rigidbody::DynamicFriction() const
 {
-	return _dynamicFriction;
+	return _properties.dynamicFriction;
 }
 
 void Rigidbody::SetDynamicFriction(const float dynamicFriction)
 {
-	_dynamicFriction = dynamicFriction;
+	_properties.dynamicFriction = dynamicFriction;
 }
 
 float Rigidbody::Restitution() const
 {
-	return _restitution;
+	return _properties.restitution;
 }
 
 void Rigidbody::SetRestitution(const float restitution)
 {
-	_restitution = restitution;
+	_properties.restitution = restitution;
+}
+
+RigidbodyManager::RigidbodyManager(core::EntityManager& entityManager)
+	: _transforms(entityManager),
+	  _velocities(entityManager),
+	  _forces(entityManager),
+	  _properties(entityManager)
+{
+}
+
+void RigidbodyManager::AddComponent(const core::Entity entity)
+{
+	_transforms.AddComponent(entity);
+	_velocities.AddComponent(entity);
+	_forces.AddComponent(entity);
+	_properties.AddComponent(entity);
+}
+
+void RigidbodyManager::RemoveComponent(const core::Entity entity)
+{
+	// The arrays share the same flag, it is only removed once
+	_transforms.RemoveComponent(entity);
+}
+
+Rigidbody RigidbodyManager::GetComponent(const core::Entity entity) const
+{
+	return {
+		_transforms.GetComponent(entity), _velocities.GetComponent(entity), _forces.GetComponent(entity),
+		_properties.GetComponent(entity)
+	};
+}
+
+void RigidbodyManager::SetComponent(const core::Entity entity, const Rigidbody& body)
+{
+	_transforms.SetComponent(entity, body.Trans());
+	_velocities.SetComponent(entity, body.Velocity());
+	_forces.SetComponent(entity, body.Force());
+	_properties.SetComponent(entity, body.Properties());
+}
+
+void RigidbodyManager::SetDirtyTracking(const bool isTracking)
+{
+	_transforms.SetDirtyTracking(isTracking);
+	_velocities.SetDirtyTracking(isTracking);
+	_forces.SetDirtyTracking(isTracking);
+	_properties.SetDirtyTracking(isTracking);
+}
+
+void RigidbodyManager::ClearDirty()
+{
+	_transforms.ClearDirty();
+	_velocities.ClearDirty();
+	_forces.ClearDirty();
+	_properties.ClearDirty();
 }
 }
@@ -25,16 +25,15 @@ void ImpulseSolver::Solve(const std::vector<Collision>& collisions, float)
 
 		if (!isRigidbodyA || !isRigidbodyB) continue;
 
-		Rigidbody& bodyA = _rigidbodyManager.GetComponent(entityA);
-		Rigidbody& bodyB = _rigidbodyManager.GetComponent(entityB);
+		// Only the properties are read here, the velocities and positions are written in their own arrays
+		const RigidbodyProperties& propertiesA = _rigidbodyManager.GetProperties(entityA);
+		const RigidbodyProperties& propertiesB = _rigidbodyManager.GetProperties(entityB);
 
-		// ReSharper disable CppCStyleCast
-		Rigidbody* aBody = bodyA.HasCollisions() ? &bodyA : nullptr;
-		Rigidbody* bBody = bodyB.HasCollisions() ? &bodyB : nullptr;
-		// ReSharper restore CppCStyleCast
+		const RigidbodyProperties* aBody = propertiesA.HasCollisions() ? &propertiesA : nullptr;
+		const RigidbodyProperties* bBody = propertiesB.HasCollisions() ? &propertiesB : nullptr;
 
-		core::Vec2f aVel = aBody ? aBody->Velocity() : core::Vec2f::Zero();
-		core::Vec2f bVel = bBody ? bBody->Velocity() : core::Vec2f::Zero();
+		core::Vec2f aVel = aBody ? _rigidbodyManager.GetVelocity(entityA) : core::Vec2f::Zero();
+		core::Vec2f bVel = bBody ? _rigidbodyManager.GetVelocity(entityB) : core::Vec2f::Zero();
 		core::Vec2f relativeVelocity = bVel - aVel;
 
 		// Calculate relative velocity in terms of the normal direction
@@ -43,12 +42,12 @@ void ImpulseSolver::Solve(const std::vector<Collision>& collisions, float)
 		// Do not resolve if velocities are separating
 		if (velocityAlongNormal >= 0) continue;
 
-		const float aInvMass = aBody ? aBody->InvMass() : 1.0f;
-		const float bInvMass = bBody ? bBody->InvMass() : 1.0f;
+		const float aInvMass = aBody ? aBody->invMass : 1.0f;
+		const float bInvMass = bBody ? bBody->invMass : 1.0f;
 
 		// Impulse
 
-		const float e = std::min(aBody ? aBody->Restitution() : 1.0f, bBody ? bBody->Restitution() : 1.0f);
+		const float e = std::min(aBody ? aBody->restitution : 1.0f, bBody ? bBody->restitution : 1.0f);
 		const float j = -(1.0f + e) * velocityAlongNormal / (aInvMass + bInvMass);
 
 		const core::Vec2f impulse = j * manifold.normal;
@@ -71,10 +70,10 @@ void ImpulseSolver::Solve(const std::vector<Collision>& collisions, float)
 
 		const float fVel = relativeVelocity.Dot(tangent);
 
-		const float aSf = aBody ? aBody->StaticFriction() : 0.0f;
-		const float bSf = bBody ? bBody->StaticFriction() : 0.0f;
-		const float aDf = aBody ? aBody->DynamicFriction() : 0.0f;
-		const float bDf = bBody ? bBody->DynamicFriction() : 0.0f;
+		const float aSf = aBody ? aBody->staticFriction : 0.0f;
+		const float bSf = bBody ? bBody->staticFriction : 0.0f;
+		const float aDf = aBody ? aBody->dynamicFriction : 0.0f;
+		const float bDf = bBody ? bBody->dynamicFriction : 0.0f;
 		float mu = core::Vec2f(aSf, bSf).GetMagnitude();
 		const float f = -fVel / (aInvMass + bInvMass);
 
@@ -93,11 +92,11 @@ void ImpulseSolver::Solve(const std::vector<Collision>& collisions, float)
 		{
 			if (friction.IsNaN())
 			{
-				aBody->SetVelocity(aVel);
+				_rigidbodyManager.GetVelocity(entityA) = aVel;
 			}
 			else
 			{
-				aBody->SetVelocity(aVel - friction * aInvMass);
+				_rigidbodyManager.GetVelocity(entityA) = aVel - friction * aInvMass;
 			}
 		}
 
@@ -105,11 +104,11 @@ void ImpulseSolver::Solve(const std::vector<Collision>& collisions, float)
 		{
 			if (friction.IsNaN())
 			{
-				bBody->SetVelocity(bVel);
+				_rigidbodyManager.GetVelocity(entityB) = bVel;
 			}
 			else
 			{
-				bBody->SetVelocity(bVel + friction * bInvMass);
+				_rigidbodyManager.GetVelocity(entityB) = bVel + friction * bInvMass;
 			}
 		}
 	}
@@ -128,16 +127,15 @@ void SmoothPositionSolver::Solve(const std::vector<Collision>& collisions, float
 
 		if (!isRigidbodyA || !isRigidbodyB) continue;
 
-		Rigidbody& bodyA = _rigidbodyManager.GetComponent(entityA);
-		Rigidbody& bodyB = _rigidbodyManager.GetComponent(entityB);
+		// Only the properties are read here, the velocities and positions are written in their own arrays
+		const RigidbodyProperties& propertiesA = _rigidbodyManager.GetProperties(entityA);
+		const RigidbodyProperties& propertiesB = _rigidbodyManager.GetProperties(entityB);
 
-		// ReSharper disable CppCStyleCast
-		Rigidbody* aBody = bodyA.HasCollisions() ? &bodyA : nullptr;
-		Rigidbody* bBody = bodyB.HasCollisions() ? &bodyB : nullptr;
-		// ReSharper restore CppCStyleCast
+		const RigidbodyProperties* aBody = propertiesA.HasCollisions() ? &propertiesA : nullptr;
+		const RigidbodyProperties* bBody = propertiesB.HasCollisions() ? &propertiesB : nullptr;
 
-		const float aInvMass = aBody ? aBody->InvMass() : 0.0f;
-		const float bInvMass = bBody ? bBody->InvMass() : 0.0f;
+		const float aInvMass = aBody ? aBody->invMass : 0.0f;
+		const float bInvMass = bBody ? bBody->invMass : 0.0f;
 
 		core::Vec2f resolution = points.b - points.a;
 
@@ -151,13 +149,13 @@ void SmoothPositionSolver::Solve(const std::vector<Collision>& collisions, float
 		if (aBody ? !aBody->IsKinematic() : false)
 		{
 			const core::Vec2f deltaA = aInvMass * correction;
-			aBody->Trans().position -= deltaA;
+			_rigidbodyManager.GetTransform(entityA).position -= deltaA;
 		}
 
 		if (bBody ? !bBody->IsKinematic() : false)
 		{
 			const core::Vec2f deltaB = bInvMass * correction;
-			bBody->Trans().position += deltaB;
+			_rigidbodyManager.GetTransform(entityB).position += deltaB;
 		}
 	}
 }
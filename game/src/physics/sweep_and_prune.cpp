@@ -0,0 +1,123 @@
+#include "physics/sweep_and_prune.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "engine/view.hpp"
+
+#include "physics/physics_manager.hpp"
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+SweepAndPrune::SweepAndPrune(core::EntityManager& entityManager, RigidbodyManager& rigidbodyManager,
+                             AabbColliderManager& aabbManager, CircleColliderManager& circleManager)
+	: _entityManager(entityManager), _rigidbodyManager(rigidbodyManager),
+	  _aabbManager(aabbManager), _circleManager(circleManager)
+{
+}
+
+void SweepAndPrune::Update()
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	// The bodies that lost their rigidbody or their collider are removed, the others get their new bounds
+	std::size_t keptCount = 0;
+	for (std::size_t i = 0; i < _bodies.size(); i++)
+	{
+		BodyBounds bounds{};
+		if (!ComputeBounds(_bodies[i].entity, bounds))
+		{
+			_isInList[_bodies[i].entity] = false;
+			continue;
+		}
+		_bodies[keptCount++] = bounds;
+	}
+	_bodies.resize(keptCount);
+
+	// The new bodies are appended, the insertion sort moves them to their place
+	const std::size_t entityCount = _entityManager.GetEntitiesSize();
+	if (_isInList.size() < entityCount)
+	{
+		_isInList.resize(entityCount, false);
+	}
+	core::View(_entityManager).With(RigidbodyManager::COMPONENT_FLAG).ForEach([this](const core::Entity entity)
+	{
+		if (_isInList[entity]) return;
+
+		BodyBounds bounds{};
+		if (!ComputeBounds(entity, bounds)) return;
+
+		_bodies.push_back(bounds);
+		_isInList[entity] = true;
+	});
+
+	// The list is almost sorted from the previous frame, each body only moves by a few places
+	for (std::size_t i = 1; i < _bodies.size(); i++)
+	{
+		const BodyBounds body = _bodies[i];
+		std::size_t j = i;
+		while (j > 0 && _bodies[j - 1].min.x > body.min.x)
+		{
+			_bodies[j] = _bodies[j - 1];
+			j--;
+		}
+		_bodies[j] = body;
+	}
+}
+
+void SweepAndPrune::GetCollisionPairs(std::vector<std::pair<core::Entity, core::Entity>>& collisionPairs)
+{
+	#ifdef TRACY_ENABLE
+	ZoneScoped;
+	#endif
+
+	_pairKeys.clear();
+	for (std::size_t i = 0; i < _bodies.size(); i++)
+	{
+		const BodyBounds& bodyA = _bodies[i];
+		// The following bodies starting after the end of this one can not overlap it
+		for (std::size_t j = i + 1; j < _bodies.size() && _bodies[j].min.x <= bodyA.max.x; j++)
+		{
+			const BodyBounds& bodyB = _bodies[j];
+			if (bodyA.min.y > bodyB.max.y || bodyB.min.y > bodyA.max.y) continue;
+
+			_pairKeys.push_back(PackPair(std::min(bodyA.entity, bodyB.entity), std::max(bodyA.entity, bodyB.entity)));
+		}
+	}
+
+	// The order of the list depends on the previous frames, the pairs are sorted to be the same after a rollback
+	std::sort(_pairKeys.begin(), _pairKeys.end());
+
+	UnpackPairs(_pairKeys, _entityManager, collisionPairs);
+}
+
+bool SweepAndPrune::ComputeBounds(const core::Entity entity, BodyBounds& bounds) const
+{
+	if (!_entityManager.HasComponent(entity, RigidbodyManager::COMPONENT_FLAG)) return false;
+
+	const ColliderPtr collider = PhysicsManager::GetCollider(_entityManager, _aabbManager, _circleManager, entity);
+
+	if (!collider) return false;
+
+	const Transform& transform = std::as_const(_rigidbodyManager).GetTransform(entity);
+	const core::Vec2f center = transform.position + collider->center;
+	const core::Vec2f size = collider.GetBoundingBoxSize() / 2.0f;
+
+	// The narrow phase scales the circles by the major scale and the boxes on each axis
+	const core::Vec2f scale = collider.GetType() == core::ComponentType::CircleCollider
+		                          ? core::Vec2f::One() * transform.scale.Major()
+		                          : transform.scale;
+	const core::Vec2f halfSize{size.x * scale.x, size.y * scale.y};
+
+	bounds.entity = entity;
+	bounds.min = center - halfSize;
+	bounds.max = center + halfSize;
+	return true;
+}
+}